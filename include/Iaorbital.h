@@ -53,6 +53,35 @@ class Iprimitive {
 	
 };
 //========================================================================
+/**
+ * Angular types of the atomic orbitals, resolved once from the symmetry strings written by the
+ * parsers, to be used by the normalization and grid kernels without string comparisons.
+ * The cartesian types are grouped by their normalization factor.
+ */
+enum ang_type {
+	ang_s		, // S
+	ang_p		, // PX, PY, PZ
+	ang_d_sq	, // XX, YY, ZZ
+	ang_d_mix	, // XY, XZ, YZ
+	ang_f_cube	, // XXX, YYY, ZZZ
+	ang_f_sq	, // XXY, XXZ, YYX, YYZ, XYY, XZZ
+	ang_f_mix	, // XYZ
+	ang_f7		, // F7
+	ang_d0		, // spherical d functions
+	ang_d1p		,
+	ang_d1n		,
+	ang_d2p		,
+	ang_d2n		,
+	ang_f0		, // spherical f functions
+	ang_f1p		,
+	ang_f1n		,
+	ang_f2p		,
+	ang_f2n		,
+	ang_f3p		,
+	ang_f3n		,
+	ang_other	  // not recognized, left unnormalized
+};
+//========================================================================
 /** 
  * This class is meant to be hold atom object abstraction to hold, manipulate and modify
  * information extracted from quantum chemical output programs.
@@ -70,6 +99,7 @@ class Iaorbital {
 		bool gto; // if the orbital is gaussian type.
 		bool spherical; // if the orbital has spherical symmetry.
 		std::string symmetry; //
+		ang_type ang; // angular type resolved from the symmetry string.
 		double n_factor; // normalization factor.
 		double alpha; // atomic orbital exponent 
 		unsigned int powx; //  
@@ -87,6 +117,7 @@ class Iaorbital {
 		//-----------------------------------------------
 		void add_primitive(double expo, double contrac); // create a Iprimitive object and store in gtos vector. 
 		void add_primitive(Iprimitive gorb); // create a Iprimitive object and store in gtos vector. 
+		void set_ang_type(); // resolve the symmetry string in the angular type.
 		bool normalize(); // calculate the normalization factor.
 		void print(); // function to print information in the console.
 		
@@ -20,15 +20,17 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include <fstream>
+#include <memory>
 //------------------------------------------
 #include "../include/common.h"
 //------------------------------------------
 class Iline; //foward declaration
+class Imapped_file;
 //-------------------------------------------------------------------------------------------
 /**
  * Class to hold and manipulate text files. Creates Ilines objects and sotre in a STL vector 
- * to hold each line of the file to be easily acessed and parsed.
+ * to hold each line of the file to be easily acessed and parsed. The file is mapped in memory
+ * and the words of the lines are views of it, kept alive while the buffer exists.
  * @class Ibuffer
  * @author Igor Barden Grillo
  * @date 07/04/18
@@ -41,6 +43,7 @@ class Ibuffer {
 		unsigned int nLines; // number of lines in the file.
 		bool parsed; // if the lines of the file were parsed and stored.
 		std::vector<Iline> lines; //Iline objects to hold each file line.
+		std::unique_ptr<Imapped_file> map; // mapped file where the words of the lines point.
 		Ibuffer(); // default constructor 
 		Ibuffer(const char* file_name,bool parse); // constructor from file path to be parsed or not.
 		Ibuffer(const char* file_name,int in, int fin); // constructor to store info from file path from block of lines.
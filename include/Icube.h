@@ -21,10 +21,18 @@
 
 #include <string>
 #include <vector> 
+#include <memory>
 
 #include "../include/common.h"
 #include "../include/Imolecule.h"
 
+template<class E> class cube_expr;
+class cube_leaf;
+template<class E, class Op> class cube_unary;
+struct op_sq;
+struct op_log;
+struct op_pow;
+
 //===================================================================================
 /**
  * This class is meant to represent an cube file object in the gaussian format that are accepted by 
@@ -50,7 +58,7 @@ class Icube {
 		double origin[3];
 		double gridsides[3];
 		unsigned int grid[3];
-		Imolecule molecule;
+		std::shared_ptr<const Imolecule> molecule; // geometry shared by the cubes of the same grid, never modified.
 		std::vector<double> scalar;
 		// constructors/destructor
 		Icube();
@@ -59,21 +67,15 @@ class Icube {
 		Icube& operator=(const Icube& rhs_cube);  
 		Icube(Icube&& rhs_cube) noexcept;
 		Icube& operator=(Icube&& rhs_cube) noexcept; 
+		template<class E> Icube(const cube_expr<E>& expr); // evaluates a cube expression, see Icube_expr.h
+		template<class E> Icube& operator=(const cube_expr<E>& expr);
 		~Icube();
 		//friend functions
 		friend bool operator==(const Icube& lhs_cube,const Icube& rhs_cube);
-		friend Icube operator-(const Icube& lhs_cube,const Icube& rhs_cube);
-		friend Icube operator+(const Icube& lhs_cube,const Icube& rhs_cube);
-		friend Icube operator*(const Icube& lhs_cube,const Icube& rhs_cube);
-		friend Icube operator/(const Icube& lhs_cube,const Icube& rhs_cube);
-		friend Icube operator-(const Icube& lhs_cube,double value);
-		friend Icube operator+(const Icube& lhs_cube,double value);
-		friend Icube operator*(const Icube& lhs_cube,double value); 
-		friend Icube operator/(const Icube& lhs_cube,double value);
 		//member functions
-		Icube scale_cube(double val);
-		Icube log_cube();
-		Icube SQ();
+		cube_unary<cube_leaf,op_pow> scale_cube(double val) const;
+		cube_unary<cube_leaf,op_log> log_cube() const;
+		cube_unary<cube_leaf,op_sq> SQ() const;
 		double calc_cube_integral();
 		void normalize( double norm );
 		double diff_integral(const Icube& cube);
@@ -82,7 +84,9 @@ class Icube {
 		double get_scalar(int x, int y, int z);
 		double get_scalar(double x, double y, double z);	 
 		void add_data(std::vector < std::vector < std::vector<double> > >& data);
+		void set_grid(const Icube& ref); // takes the grid information of ref and allocates the voxels, without setting their values.
 		void write_cube(std::string cubeName);
+		void write_cube(std::string cubeName, int nthr); // nthr threads format the voxel values.
 		void get_cube_stats(double& mean, double& min, double& max);
 		void print();
 };
@@ -106,6 +110,8 @@ class cube_diffs {
 		void write();
 };
 
+#include "../include/Icube_expr.h"
+
 #endif 
 //================================================================================
 //END OF FILE
@@ -0,0 +1,186 @@
+// Icube_expr.h
+// header file with the expression templates for the Icube arithmetic
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+
+#ifndef CUBE_EXPR
+#define CUBE_EXPR
+
+#include <cmath>
+#include <type_traits>
+#include <omp.h>
+
+//===================================================================================
+/**
+ * Lazy expressions of the Icube arithmetic. The operators between cubes and scalars,
+ * SQ, log_cube and scale_cube build light objects holding references to the operand cubes,
+ * and the whole expression is evaluated voxel by voxel in a single OpenMP loop when it is
+ * assigned to, or used to construct, an Icube. The grid information and the molecule of the
+ * result are taken from the leftmost cube of the expression, as the former operators did.
+ * The expressions must be consumed in the same statement where they are built.
+ * @date 17/10/26
+ * @file Icube_expr.h
+ * @brief Expression templates for the Icube operators.
+ * @see Icube
+ */
+struct cube_expr_tag {};
+//-----------------------------------------------------------------------------------
+template<class E>
+class cube_expr : public cube_expr_tag {
+	public:
+		const E& self() const { return static_cast<const E&>(*this); }
+		double at(unsigned int i) const { return self().at(i); }
+		const Icube& ref() const { return self().ref(); }
+};
+//-----------------------------------------------------------------------------------
+class cube_leaf : public cube_expr<cube_leaf> {
+	public:
+		const Icube& cube;
+		explicit cube_leaf(const Icube& c) : cube(c) {}
+		double at(unsigned int i) const { return cube.scalar[i]; }
+		const Icube& ref() const { return cube; }
+};
+//-----------------------------------------------------------------------------------
+// element operations
+struct op_add		{ static double apply(double a, double b) { return a + b; } };
+struct op_sub		{ static double apply(double a, double b) { return a - b; } };
+struct op_mul		{ static double apply(double a, double b) { return a * b; } };
+struct op_div_val	{ static double apply(double a, double b) { return a / b; } };
+// voxels with null denominator are set to 1000, as in the former cube division
+struct op_div		{ static double apply(double a, double b) { return b == 0.00 ? 1000.0 : a / b; } };
+struct op_sq		{ static double apply(double a, double)   { return a*a; } };
+struct op_log		{ static double apply(double a, double)   { return log(a); } };
+struct op_pow		{ static double apply(double a, double b) { return pow(a,b); } };
+//-----------------------------------------------------------------------------------
+template<class L, class R, class Op>
+class cube_binary : public cube_expr< cube_binary<L,R,Op> > {
+	public:
+		L lhs;
+		R rhs;
+		cube_binary(const L& l, const R& r) : lhs(l), rhs(r) {}
+		double at(unsigned int i) const { return Op::apply( lhs.at(i), rhs.at(i) ); }
+		const Icube& ref() const { return lhs.ref(); }
+};
+//-----------------------------------------------------------------------------------
+// operation of the expression with a scalar value, also used for the unary functions
+template<class E, class Op>
+class cube_unary : public cube_expr< cube_unary<E,Op> > {
+	public:
+		E arg;
+		double value;
+		cube_unary(const E& e, double val) : arg(e), value(val) {}
+		double at(unsigned int i) const { return Op::apply( arg.at(i), value ); }
+		const Icube& ref() const { return arg.ref(); }
+};
+//-----------------------------------------------------------------------------------
+// Icube operands are wrapped in leaves, expressions are kept by value
+inline cube_leaf as_cube_expr(const Icube& c) { return cube_leaf(c); }
+template<class E>
+const E& as_cube_expr(const cube_expr<E>& e) { return e.self(); }
+
+template<class T>
+struct is_cube_operand : std::integral_constant<bool, std::is_same<T,Icube>::value || std::is_base_of<cube_expr_tag,T>::value> {};
+
+template<class T>
+using cube_operand_t = typename std::decay< decltype( as_cube_expr( std::declval<const T&>() ) ) >::type;
+
+template<class L, class R, class Op>
+using cube_binary_t = typename std::enable_if< is_cube_operand<L>::value && is_cube_operand<R>::value,
+											   cube_binary< cube_operand_t<L>, cube_operand_t<R>, Op > >::type;
+template<class L, class Op>
+using cube_scalar_t = typename std::enable_if< is_cube_operand<L>::value, cube_unary< cube_operand_t<L>, Op > >::type;
+//-----------------------------------------------------------------------------------
+template<class L, class R>
+cube_binary_t<L,R,op_add> operator+(const L& lhs, const R& rhs){
+	return cube_binary_t<L,R,op_add>( as_cube_expr(lhs), as_cube_expr(rhs) );
+}
+template<class L, class R>
+cube_binary_t<L,R,op_sub> operator-(const L& lhs, const R& rhs){
+	return cube_binary_t<L,R,op_sub>( as_cube_expr(lhs), as_cube_expr(rhs) );
+}
+template<class L, class R>
+cube_binary_t<L,R,op_mul> operator*(const L& lhs, const R& rhs){
+	return cube_binary_t<L,R,op_mul>( as_cube_expr(lhs), as_cube_expr(rhs) );
+}
+template<class L, class R>
+cube_binary_t<L,R,op_div> operator/(const L& lhs, const R& rhs){
+	return cube_binary_t<L,R,op_div>( as_cube_expr(lhs), as_cube_expr(rhs) );
+}
+template<class L>
+cube_scalar_t<L,op_add> operator+(const L& lhs, double value){
+	return cube_scalar_t<L,op_add>( as_cube_expr(lhs), value );
+}
+template<class L>
+cube_scalar_t<L,op_sub> operator-(const L& lhs, double value){
+	return cube_scalar_t<L,op_sub>( as_cube_expr(lhs), value );
+}
+template<class L>
+cube_scalar_t<L,op_mul> operator*(const L& lhs, double value){
+	return cube_scalar_t<L,op_mul>( as_cube_expr(lhs), value );
+}
+template<class L>
+cube_scalar_t<L,op_div_val> operator/(const L& lhs, double value){
+	return cube_scalar_t<L,op_div_val>( as_cube_expr(lhs), value );
+}
+//-----------------------------------------------------------------------------------
+template<class E>
+Icube::Icube(const cube_expr<E>& expr)	:
+	Icube()								{
+	*this = expr;
+}
+/***************************************************************************/
+template<class E>
+Icube& Icube::operator=(const cube_expr<E>& expr){
+	const Icube& ref = expr.ref();
+	unsigned int n = ref.voxelN;
+	// an expression can hold this cube, so its values are evaluated in place
+	if ( this != &ref ){
+		name		= ref.name;
+		elec_dens	= ref.elec_dens;
+		MOn			= ref.MOn;
+		voxelN		= ref.voxelN;
+		header		= ref.header;
+		molecule	= ref.molecule;
+		for(int i=0;i<3;i++){
+			origin[i]		= ref.origin[i];
+			gridsides[i]	= ref.gridsides[i];
+			grid[i]			= ref.grid[i];
+		}
+		if ( scalar.size() != n ) scalar.resize(n);
+	}
+	const E& e = expr.self();
+	omp_set_num_threads(NP);
+	#pragma omp parallel for
+	for(unsigned int x=0;x<n;x++) { scalar[x] = e.at(x); }
+	return *this;
+}
+/***************************************************************************/
+inline cube_unary<cube_leaf,op_pow> Icube::scale_cube(double val) const {
+	return cube_unary<cube_leaf,op_pow>( cube_leaf(*this), val );
+}
+/***************************************************************************/
+inline cube_unary<cube_leaf,op_log> Icube::log_cube() const {
+	return cube_unary<cube_leaf,op_log>( cube_leaf(*this), 0.0 );
+}
+/***************************************************************************/
+inline cube_unary<cube_leaf,op_sq> Icube::SQ() const {
+	return cube_unary<cube_leaf,op_sq>( cube_leaf(*this), 0.0 );
+}
+
+#endif
+//================================================================================
+//END OF FILE
+//================================================================================
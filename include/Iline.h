@@ -18,12 +18,15 @@
 //================================
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 //=====================================================================================================
 /**
  * Class to hold information and manipulate text lines. Reunite tools to parse files by make tests with
- * the text lines content and features.
+ * the text lines content and features. The words are views of the characters, without copies, pointing
+ * to the file mapped by the Ibuffer or to the own copy of the line when it is created from a string.
+ * The numbers are converted on demand from the views.
  * @class Iline
  * @author Igor Barden Grillo
  * @date 07/04/18
@@ -32,9 +35,11 @@
  */
 class Iline {
 	public:
-		std::vector<std::string> words; //words of the line.
+		std::vector<std::string_view> words; //words of the line.
 		unsigned int line_len; //line length
+		std::string text; //own copy of the characters, empty if the words point to a mapped file.
 		Iline();  // default constructor
+		Iline(const char* first, const char* last); // constructor overload from characters kept alive by the caller
 		Iline(std::string Line); // constructor overload from string
 		Iline(char* Line); // constructor overload from char*
 		Iline(const Iline& rhs_line); // copy constructor
@@ -42,6 +47,8 @@ class Iline {
 		Iline(Iline&& rhs_line) noexcept; // move constructor
 		Iline& operator=(Iline&& rhs_line) noexcept; // move assign operator overload
 		~Iline(); // destructor
+		void tokenize(const char* it, const char* fin); // split the characters in word views.
+		void rebase(const char* old_text); // point the words to text after it was copied or moved.
 		
 		bool IF_word(std::string& s,unsigned int pos);
 		bool IF_word(std::string& s,unsigned int pos, unsigned int fin);
@@ -56,7 +63,7 @@ class Iline {
 		double pop_double_f(int pos);
 		double get_double_f(int pos);
 		std::string pop_string(int pos);
-		std::string& get_string(int pos);
+		std::string get_string(int pos);
 		void print();
 };
 //=====================================================
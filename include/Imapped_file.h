@@ -0,0 +1,67 @@
+//Imapped_file.h
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#ifndef IMAPPED_FILE
+#define IMAPPED_FILE
+//------------------------------------------
+#include <cstddef>
+//-------------------------------------------------------------------------------------------
+/**
+ * Read only view of a whole file mapped in memory, to be parsed in place without copies
+ * of its lines. Uses the file mapping of Windows or mmap on POSIX systems, the mapping
+ * is released in the destructor.
+ * @class Imapped_file
+ * @author Igor Barden Grillo
+ * @date 17/10/26
+ * @file Imapped_file.h
+ * @brief Class to map a text file in memory for zero copy parsing.
+ */
+class Imapped_file {
+	public:
+		const char* data; // first character of the file, nullptr if it was not mapped.
+		std::size_t size; // number of characters in the file.
+		void* handle; // file mapping object in Windows.
+		Imapped_file() = delete;
+		explicit Imapped_file(const char* file_name); // map the file, check is_open() afterwards.
+		Imapped_file(const Imapped_file& rhs) = delete;
+		Imapped_file& operator=(const Imapped_file& rhs) = delete;
+		bool is_open() const { return data != nullptr; }
+		const char* begin() const { return data; }
+		const char* end() const { return data + size; }
+		~Imapped_file(); // unmap the file.
+};
+
+/**
+ * Advance the pointer to the first character of the next line, or to fin.
+ */
+inline const char* next_line(const char* it, const char* fin){
+	while( it < fin && *it != '\n' ) ++it;
+	return it < fin ? it+1 : fin;
+}
+
+/**
+ * Advance the pointer over spaces, tabs and carriage returns without crossing the line end.
+ */
+inline const char* skip_blanks(const char* it, const char* fin){
+	while( it < fin && ( *it == ' ' || *it == '\t' || *it == '\r' ) ) ++it;
+	return it;
+}
+
+#endif
+
+//================================================================================
+//END OF FILE
+//================================================================================
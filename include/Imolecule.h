@@ -76,6 +76,10 @@ class Imolecule {
 		std::vector <int> occupied;
 		std::vector <int> occupied_beta;
 		std::vector<Iatom> atoms;
+		std::vector<unsigned int> ao_offset; // index of the first atomic orbital of each atom, the number of atomic orbitals at the end.
+		std::vector<unsigned int> lmo_first; // first stored coefficient of each localized MO, one more entry at the end.
+		std::vector<unsigned int> lmo_ao; // atomic orbital of each stored localized MO coefficient, ascending in each MO.
+		std::vector<double> lmo_coeff; // non-negligible localized MO coefficients, stored in place of coeff_MO.
 		// constructors/destructor
 		Imolecule(); 
 		Imolecule(const Imolecule& rhs_molecule);
@@ -90,13 +94,19 @@ class Imolecule {
 		void write_xyz();
 		void mol_vert_up();
 		std::vector<double> extract_MO(int MO,bool beta);
+		bool sparse_MO() const; // if the alpha coefficients are stored only in the compressed rows.
+		double get_coeff(unsigned int MO, unsigned int ao) const;
 		void print();
 		void ang_to_bohr();
 		void bohr_to_ang();
 		void norm_orbs();
 		int get_ao_number();
+		void set_ao_offset(); // builds the atomic orbitals offsets of the atoms.
 		double get_homo();
 		double get_lumo();
+		unsigned int lumo_index() const; // LUMO index from the electrons and the formal charge, as update() counts them.
+		unsigned int MO_window(const std::vector<double>& energies, int band, double conv) const; // number of lowest MOs whose coefficients the descriptors use.
+		bool MO_loaded(int band) const; // if the MO coefficients were loaded up to the band after the LUMO.
 		void print_basis();
 		void update();
 		void clear();
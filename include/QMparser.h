@@ -48,14 +48,17 @@ class QMparser{
 		std::string program;
 		bool parsed;
 		const char* name_f;
+		int mo_band; // virtual MOs after the LUMO whose coefficients are loaded, with the ones inside the energy criteria; every MO for a negative value.
 		//constructors/destructor
 		QMparser();
 		QMparser(const char* file_name, std::string Program);
+		QMparser(const char* file_name, std::string Program, int band);
 		QMparser(const QMparser& rhs_QMp) = delete;
 		QMparser& operator=(const QMparser& rhs_QMp) = delete;
 		~QMparser();
 		//member functions
 		Imolecule get_molecule();
+		Imolecule parse_file(int band); // parse the file loading the MO coefficients of the window of the band.
 	
 };
  
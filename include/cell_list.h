@@ -0,0 +1,96 @@
+// cell_list.h
+// header file for the cell list used to sum the coulomb potential of point charges
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+
+#ifndef CELL_LIST
+#define CELL_LIST
+
+#include <vector>
+
+class Icube;
+class Imolecule;
+//==================================================================================
+/**
+ * Multipole moments of the charges inside one cell, taken about the cell center.
+ * @class cell_moments
+ * @date 17/10/26
+ * @file cell_list.h
+ * @brief Charge, dipole and traceless quadrupole of a cell.
+ */
+class cell_moments {
+	public:
+		double center[3];
+		double radius; // largest distance of a charge of the cell to its center.
+		double q;
+		double dip[3];
+		double quad[6]; // xx, yy, zz, xy, xz, yz of sum q(3 r_i r_j - r^2 delta_ij).
+		unsigned int count; // number of charges in the cell.
+};
+//==================================================================================
+/**
+ * Class to evaluate the coulomb potential of point charges, V(r) = sum_i q_i/|r-r_i|, on
+ * the points of a grid. The charges are sorted in a cell list and the cells are grouped in
+ * coarser levels, each cell of a level holding eight cells of the level below. For each block
+ * of voxels the cells are opened from the coarsest level down: a cell seen from the block
+ * under an angle smaller than theta enters through its multipole expansion up to the
+ * quadrupole, the charges of the leaf cells close to the block are summed exactly.
+ * The potential at the charges themselves, for the condensed descriptors, reuses the lists of
+ * exact pairs ( with their inverse distances ) and of far cells built once by set_neighbours, so
+ * each new set of charges only needs its cell moments. Without a cutoff all pairs are exact.
+ * @class cell_list
+ * @date 17/10/26
+ * @file cell_list.h
+ * @brief Cell list with multipole far field for point charge potentials.
+ * @see Icube
+ */
+class cell_list {
+	public:
+		//member variables
+		double theta; // opening criterion, cell radius over its distance to the voxel block.
+		double side; // edge of the leaf cells.
+		double origin[3]; // lower corner of the cell list.
+		std::vector<double> xyz; // coordinates of the charges sorted by leaf cell.
+		std::vector<double> charges; // charges sorted by leaf cell.
+		std::vector<unsigned int> index; // position of the sorted charges in the input.
+		std::vector<unsigned int> first; // first charge of each leaf cell, one more entry at the end.
+		std::vector< std::vector<unsigned int> > dims; // cells in each direction for each level.
+		std::vector< std::vector<cell_moments> > levels; // moments of the cells, level 0 being the leaf cells.
+		double cutoff; // pairs closer than this are always exact, 0 for all pairs exact.
+		std::vector<unsigned int> near_first; // first exact pair of each charge, one more entry at the end.
+		std::vector<unsigned int> near_index; // other charge of the exact pairs, in input order.
+		std::vector<double> near_inv; // inverse distance of the exact pairs.
+		std::vector<unsigned int> far_first; // first far cell of each charge, one more entry at the end.
+		std::vector<unsigned int> far_cells; // level and index of the far cells.
+		//constructors/destructor
+		cell_list();
+		cell_list(const std::vector<double>& coords, const std::vector<double>& q);
+		cell_list(const Imolecule& mol, const std::vector<double>& q);
+		~cell_list();
+		//member functions
+		void build(const std::vector<double>& coords, const std::vector<double>& q);
+		void set_moments(const std::vector<double>& q, std::vector< std::vector<cell_moments> >& lvls) const;
+		void set_neighbours(double cut);
+		bool same_coords(const Imolecule& mol) const; // if the charges sit on the atoms of the molecule.
+		std::vector<double> charge_potential(const std::vector<double>& q) const; // sum of q_j/r_ij over j != i for each charge.
+		unsigned int cell(unsigned int lvl, unsigned int i, unsigned int j, unsigned int k) const;
+		void potential(Icube& out, double precision) const;
+};
+
+#endif
+//================================================================================
+//END OF FILE
+//================================================================================
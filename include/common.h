@@ -22,6 +22,7 @@
 //Including header from the c++
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector> 
 #include <memory>
 #include <experimental/filesystem>
@@ -37,6 +38,10 @@ extern bool dos;
 extern bool extra_RD;
 extern bool pymol_script;
 extern double energy_crit; 
+extern double ao_tol; // atomic orbital values below this are screened out of the grid evaluation.
+extern unsigned int vol_out; // grid output: 0 for text cubes, 1 for volume files with double and 2 with float values.
+extern double pair_cutoff; // distance in angstroms within which the condensed pair potentials are exact, beyond it cells enter as multipoles; 0 sums every pair exactly.
+extern std::string lrd_list; // comma separated names of the volumetric descriptors to calculate, all of them when empty.
 extern bool M_R;
 extern bool comp_H;
 
@@ -160,7 +165,7 @@ std::string get_file_ext(const char* path_name);
  * @param Double to be converted
  * @return Double with the converted values
  */
-double D_E_conv(std::string sc_not);
+double D_E_conv(std::string_view sc_not);
 
 //---------------------------------------------------------------------------------------
 /**
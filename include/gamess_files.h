@@ -43,6 +43,7 @@ class gamess_files{
 		//member variables
 		const char* name_f;
 		bool is_open;
+		int mo_band; // band of virtual MOs to load, all for < 0
 		Imolecule molecule;
 		// constructors/destructor
 		gamess_files();
@@ -43,6 +43,7 @@ class gaussian_files{
 		const char* name_f;
 		Imolecule molecule;
 		bool is_open;
+		int mo_band; // band of virtual MOs to load, all for < 0
 		//constructors/destructor
 		gaussian_files();
 		~gaussian_files();
@@ -22,6 +22,8 @@
 // C++ header files
 #include <iostream>
 #include <string>
+#include <vector>
+#include <Eigen/Core>
 //Our library includes
 #include "../include/common.h"
 #include "../include/Icube.h"
@@ -53,8 +55,8 @@ class gridgen {
 		std::vector<double> AOxcoords;
 		std::vector<double> AOycoords;
 		std::vector<double> AOzcoords; 
+		std::vector<double> AOextent; // radius beyond which the atomic orbital is below ao_tol.
 		std::vector<Iaorbital> orbs;
-		std::vector< std::vector < std::vector<double> > > psi;
 		Icube density;
 		// constructos/destructor
 		gridgen();
@@ -65,15 +67,21 @@ class gridgen {
 		//member functions
 		double calc_slater_orb(int i, int x, int y, int z);
 		double calc_gauss_orb(int i, int x, int y, int z);
+		double calc_sphe_angular(int i, double xi, double yi, double zi);
 		double calc_orca_sphe(int i, int x, int y, int z);
 		double calc_aorb(int i, int x, int y, int z);
-		double calc_orb_voxel(int nm,int x,int y,int z, bool beta);
-		double calc_orb_voxel_orca(int nm,int x,int y,int z,bool beta);
+		void calc_ao_extents();
+		void screen_block(unsigned int bx, unsigned int by, unsigned int bz, std::vector<unsigned int>& aos);
+		void restrict_aos(const std::vector<char>& used, std::vector<unsigned int>& aos);
 		void calculate_orb(int Nmo,bool beta);
 		void calculate_orb_orca(int Nmo,bool beta);
-		double electron_density_mo(int x, int y, int z);
-		double electron_density_mo_orca(int x, int y, int z);
+		void calc_ao_block(unsigned int bx, unsigned int by, unsigned int bz, const std::vector<unsigned int>& aos, Eigen::MatrixXd& phi);
+		std::vector<char> mo_support(const std::vector<int>& mos, bool beta);
+		void block_coeff(const std::vector<unsigned int>& aos, const std::vector<int>& mos, bool beta, Eigen::MatrixXd& cmo);
+		std::vector<Icube> calculate_orbs(const std::vector<int>& mos, bool beta);
+		Icube calc_band(const std::vector<int>& mos, const std::vector<double>& weights, bool square);
 		double electron_density(int x, int y, int z);
+		void calc_density_matrix(Eigen::MatrixXd& P);
 		void calculate_density();
 		void calculate_density_orca();
 		void orbs_overlap();
@@ -56,6 +56,8 @@ class local_rd {
 		int charge;
 		std::vector<Icube> lrds;
 		std::vector<std::string> rd_names;
+		std::vector<bool> requested; // descriptors to be written.
+		std::vector<bool> needed; // descriptors to be calculated, the requested ones and their prerequisites.
 		//constructors/destructor
 		local_rd();
 		local_rd(Icube HOmo,  Icube LUmo);
@@ -67,8 +69,10 @@ class local_rd {
 		local_rd& operator=(local_rd&& lrd_rhs) noexcept;
 		~local_rd();
 		//member functions
+		void set_requests(); // marks the descriptors from the lrd_list option.
 		friend local_rd operator-(const local_rd& lrd_lhs,const local_rd& lrd_rhs);	
 		void calculate_fukui_Band(const Icube& homo_b, const Icube& lumo_b);
+		void calculate_pointwise(const global_rd* grd); // one pass over the voxels for the descriptors 5-8 and, with grd, 14-18.
 		void calculate_RD(const global_rd& grd);
 		void calculate_Fukui_potential();
 		void calculate_hardness(const global_rd& grd);
@@ -23,6 +23,7 @@
 #include <string> 
 #include <vector>
 #include <cmath>
+#include <memory>
 //include statements from PRIMORDiA-libs
 #include "../include/common.h"
 #include "../include/Imolecule.h"
@@ -33,6 +34,7 @@ class QMdriver;
 class global_rd;
 class Iprotein;
 class protein_lrd;
+class cell_list;
 
 //===============================================================
 class local_rd_cnd{
@@ -44,6 +46,7 @@ class local_rd_cnd{
 		unsigned charge;
 		std::vector< std::vector<double> > lrds;
 		std::vector<std::string> names;
+		std::shared_ptr<const cell_list> atom_pairs; // atom pairs shared by the potentials and the Vee hardness.
 		//constructors/destructor
 		local_rd_cnd();
 		local_rd_cnd(unsigned int nof);
@@ -55,8 +58,10 @@ class local_rd_cnd{
 		~local_rd_cnd();
 		//member functions
 		friend local_rd_cnd operator-(const local_rd_cnd& lrd_lhs,const local_rd_cnd& lrd_rhs);
+		std::vector<double> atomic_populations(const Imolecule& molecule, const std::vector<double>& weights, bool beta); // sum of the MO populations of each atom, weighted by MO.
 		void calculate_frontier_orbitals( Imolecule& molecule, unsigned band );
 		void energy_weighted_fukui_functions( const Imolecule& molecule );
+		const cell_list& neighbours(const Imolecule& molecule); // atom pairs of the molecule, rebuilt when its coordinates change.
 		void calculate_fukui_potential( const Imolecule& molecule);
 		void calculate_hardness(const global_rd& grd, const Imolecule& molecule);
 		void calculate_RD(const global_rd& grd);
@@ -38,6 +38,7 @@ class mopac_files{
 		const char* name_f;
 		bool is_open;
 		std::string type;
+		int mo_band; // band of virtual MOs to load, all for < 0
 		Imolecule molecule;
 		//constructors/destructor
 		mopac_files();
@@ -0,0 +1,47 @@
+// orb_kernels.h
+// header file for the vectorized radial kernels of the atomic orbitals on the grid
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+
+#ifndef ORB_KERNELS
+#define ORB_KERNELS
+
+//==================================================================================
+/**
+ * Radial kernels evaluated along a line of voxels, used by gridgen to build the atomic
+ * orbital values of each voxel block. The exponential is a polynomial approximation without
+ * libm calls, so the loops are vectorized by the compiler. Each kernel is compiled for AVX-512,
+ * AVX2 and the baseline instruction set, and the version used is chosen at run time
+ * from the processor features.
+ * @date 17/10/26
+ * @file orb_kernels.h
+ * @brief Run time dispatched SIMD kernels for the Slater and Gaussian radial functions.
+ * @see gridgen
+ */
+
+// out[i] = scale*exp( -expo*d[i]*d[i] ), one axis factor of a gaussian primitive.
+void gauss_line(unsigned int n, const double* d, double expo, double scale, double* out);
+// out[i] = r^nr*exp( -alpha*r ), r = sqrt( rxy2 + z[i]*z[i] ), radial part of a Slater orbital, nr >= 0.
+void slater_line(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out);
+// name of the instruction set selected for the kernels.
+const char* orb_kernels_isa();
+// largest relative error of the kernel exponential against std::exp, evaluated in the scalar code.
+double orb_kernels_error();
+
+#endif
+//================================================================================
+//END OF FILE
+//================================================================================
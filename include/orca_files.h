@@ -44,6 +44,7 @@ class orca_files{
 		const char* name_f;
 		Imolecule molecule;
 		bool is_open;
+		int mo_band; // band of virtual MOs to load, all for < 0
 		//costructors/destructor
 		orca_files();
 		~orca_files();
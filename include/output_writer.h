@@ -0,0 +1,71 @@
+//output_writer.h
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#ifndef OUTPUT_WRITER
+#define OUTPUT_WRITER
+//------------------------------------------
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+//------------------------------------------
+class Icube; //foward declaration
+//-------------------------------------------------------------------------------------------
+/**
+ * Pool of background threads writing the output files, so the descriptor calculations go on
+ * while the files are formatted and written. Each job holds its own copy of the data, and
+ * submit blocks while the data of the pending jobs exceeds the memory cap. The threads are
+ * started with the first job and the jobs are finished before the program ends, in finish().
+ * @class output_writer
+ * @author Igor Barden Grillo
+ * @date 17/10/26
+ * @file output_writer.h
+ * @brief Class to write the output files asynchronously.
+ */
+class output_writer {
+	public:
+		unsigned int nthreads; // number of writer threads, 0 writes in the calling thread.
+		std::size_t mem_cap; // maximum bytes held by the pending jobs.
+		std::size_t pending; // bytes held by the pending jobs.
+		unsigned int running; // jobs being written.
+		bool stop;
+		std::deque< std::pair<std::function<void()>,std::size_t> > jobs;
+		std::vector<std::thread> workers;
+		std::mutex mtx;
+		std::condition_variable cv_jobs; // signals new jobs to the workers.
+		std::condition_variable cv_done; // signals finished jobs to the waiting submitters.
+		output_writer(unsigned int nthr, std::size_t cap);
+		output_writer(const output_writer& rhs) = delete;
+		output_writer& operator=(const output_writer& rhs) = delete;
+		void submit(std::function<void()> job, std::size_t bytes); // queues a job holding bytes of data.
+		void submit_cube(const Icube& cube, const std::string& file_name); // writes a copy of the cube.
+		void submit_text(std::string text, const std::string& file_name); // writes the text to the file.
+		void wait(); // blocks until all the queued jobs are written.
+		void finish(); // waits the jobs and stops the threads.
+		void work(); // loop of the writer threads.
+		~output_writer();
+};
+
+extern output_writer out_writer; // global writer used for the descriptor output files.
+
+#endif
+
+//================================================================================
+//END OF FILE
+//================================================================================
@@ -0,0 +1,66 @@
+// poisson_fft.h
+// header file for the FFT based Poisson solver used for the volumetric coulomb integrals
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+
+#ifndef POISSON_FFT
+#define POISSON_FFT
+
+#include <vector>
+#include <complex>
+
+#include "../include/common.h"
+
+class Icube;
+//==================================================================================
+/**
+ * Class to calculate the coulomb potential generated by a volumetric scalar field,
+ * V(r) = sum_r' rho(r')/|r-r'| dV, as a convolution of the grid with the 1/r kernel
+ * evaluated by fast Fourier transforms. The grid is zero padded to at least twice its size
+ * in each dimension to get free-space ( non periodic ) boundaries. The singular self-voxel
+ * term uses the average of 1/r over the voxel volume.
+ * The transformed kernel depends only on the grid geometry and is reused for all fields
+ * calculated with the same object.
+ * @class poisson_fft
+ * @date 17/10/26
+ * @file poisson_fft.h
+ * @brief FFT convolution Poisson solver for Icube scalar fields.
+ * @see Icube
+ */
+class poisson_fft {
+	public:
+		//member variables
+		unsigned int grid[3]; // points of the original grid.
+		unsigned int pad[3]; // points of the zero padded grid.
+		double gridsides[3];
+		double volume; // voxel volume.
+		std::vector<double> kernel_ft; // transformed kernel, real since 1/r is even.
+		//constructors/destructor
+		poisson_fft();
+		poisson_fft(const Icube& grid_ref);
+		poisson_fft(const poisson_fft& rhs) = delete;
+		poisson_fft& operator=(const poisson_fft& rhs) = delete;
+		~poisson_fft();
+		//member functions
+		Icube potential(const Icube& dens);
+		void transform(std::vector< std::complex<double> >& data, bool inverse);
+		void transform_axis(std::vector< std::complex<double> >& data, int axis, unsigned int lim_a, unsigned int lim_b, bool inverse);
+};
+
+#endif
+//================================================================================
+//END OF FILE
+//================================================================================
@@ -0,0 +1,127 @@
+//volume_file.h
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#ifndef VOLUME_FILE
+#define VOLUME_FILE
+//------------------------------------------
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdint>
+//------------------------------------------
+class Icube; //foward declaration
+class Imolecule;
+class Imapped_file;
+//-------------------------------------------------------------------------------------------
+/*
+ * Layout of the .pvol files, all values in the byte order of the writing machine:
+ *   "PVOL", uint32 version
+ *   uint32 grid[3], double origin[3], double gridsides[3]
+ *   uint32 number of atoms, then uint32 atomic number and double x,y,z for each atom
+ *   data blocks of the fields
+ *   index: uint32 number of fields, then for each field its name, header, elec_dens flag,
+ *          MO number, value size ( 4 or 8 bytes ), codec, offset and size of the data block
+ *   uint64 offset of the index, "PVIX"
+ * The strings are stored as uint32 length followed by the characters.
+ */
+//-------------------------------------------------------------------------------------------
+/**
+ * Entry of the index of a volume file, locating the data block of one field.
+ * @class volume_field
+ * @author Igor Barden Grillo
+ * @date 17/10/26
+ * @file volume_file.h
+ * @brief Index entry of a field stored in a PRIMoRDiA volume file.
+ */
+class volume_field {
+	public:
+		std::string name; // descriptor name.
+		std::string header; // cube header lines.
+		bool elec_dens;
+		int MOn;
+		unsigned int value_size; // 8 for double and 4 for float storage.
+		unsigned int codec; // 0 for raw values, 1 for the lossless compression.
+		std::uint64_t offset; // position of the data block in the file.
+		std::uint64_t nbytes; // size of the data block.
+};
+//-------------------------------------------------------------------------------------------
+/**
+ * Writes several scalar fields of the same grid in one indexed binary file. The values can
+ * be stored as float to halve the size and each field is compressed with a lossless scheme
+ * (exclusive or with the previous value, byte planes and zero runs), kept raw if it does not shrink.
+ * @class volume_writer
+ * @author Igor Barden Grillo
+ * @date 17/10/26
+ * @file volume_file.h
+ * @brief Class to write scalar fields in a PRIMoRDiA volume file.
+ */
+class volume_writer {
+	public:
+		std::string name; // file name.
+		bool single; // store the values as float.
+		bool compress; // apply the lossless compression to the fields.
+		std::ofstream file;
+		std::vector<volume_field> fields;
+		volume_writer() = delete;
+		volume_writer(const std::string& file_name, const Icube& grid_ref, bool single_prec, bool compression); // writes the grid and atoms.
+		volume_writer(const volume_writer& rhs) = delete;
+		volume_writer& operator=(const volume_writer& rhs) = delete;
+		void add_field(const Icube& cube, const std::string& field_name); // appends the field values.
+		void close(); // writes the index, called by the destructor if not before.
+		~volume_writer();
+};
+//-------------------------------------------------------------------------------------------
+/**
+ * Reads the grid and the index of a volume file mapped in memory, each field is decoded
+ * only when requested, straight from its offset.
+ * @class volume_reader
+ * @author Igor Barden Grillo
+ * @date 17/10/26
+ * @file volume_file.h
+ * @brief Class to read scalar fields from a PRIMoRDiA volume file.
+ */
+class volume_reader {
+	public:
+		std::string name; // file name.
+		bool valid; // the file was mapped and its index read.
+		unsigned int grid[3];
+		double origin[3];
+		double gridsides[3];
+		std::shared_ptr<const Imolecule> molecule;
+		std::vector<volume_field> fields;
+		std::unique_ptr<Imapped_file> map;
+		volume_reader() = delete;
+		volume_reader(const char* file_name);
+		volume_reader(const volume_reader& rhs) = delete;
+		volume_reader& operator=(const volume_reader& rhs) = delete;
+		int find_field(const std::string& field_name) const; // index of the field, -1 if absent.
+		Icube get_field(unsigned int i) const;
+		Icube get_field(const std::string& field_name) const;
+		~volume_reader();
+};
+//-------------------------------------------------------------------------------------------
+/**
+ * Loads a scalar field from a text cube file or from a volume file. A field of a volume file is
+ * given as file.pvol:field_name, without the field name the first field of the file is read.
+ */
+Icube load_cube(const std::string& file_spec);
+
+#endif
+
+//================================================================================
+//END OF FILE
+//================================================================================
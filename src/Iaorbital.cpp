@@ -90,6 +90,7 @@ Iaorbital::Iaorbital()	:
 	gto(false)			,
 	spherical(false)	,
 	symmetry("S")		,
+	ang(ang_s)			,
 	n_factor(0.0)		,
 	alpha(0.0)			,
 	powx(0)				,
@@ -102,8 +103,9 @@ Iaorbital::Iaorbital(unsigned int level	,
 							double coef):
 	shell(level)						,
 	gto(false)							,
-	symmetry( move(sym) )				,
 	spherical(false)					,
+	symmetry( move(sym) )				,
+	ang(ang_s)							,
 	n_factor(0.0)						,
 	alpha(coef)							,
 	powx(0)								,
@@ -130,7 +132,7 @@ Iaorbital::Iaorbital(unsigned int level	,
 		powx = 2;
 		powy = 0;
 		powz = 0;
-	}else if (symmetry == "YX"){
+	}else if (symmetry == "YY"){
 		powx = 0;
 		powy = 2;
 		powz = 0;
@@ -151,13 +153,15 @@ Iaorbital::Iaorbital(unsigned int level	,
 		powy = 1;
 		powz = 0;
 	}
+	this->set_ang_type();
 }
 /*****************************************************************************/
 Iaorbital::Iaorbital(const Iaorbital& rhs_orb)	:
 		shell(rhs_orb.shell)					,
 		gto(rhs_orb.gto)						,
-		symmetry(rhs_orb.symmetry)				,
 		spherical(rhs_orb.spherical)			,
+		symmetry(rhs_orb.symmetry)				,
+		ang(rhs_orb.ang)						,
 		n_factor(rhs_orb.n_factor)				,
 		alpha(rhs_orb.alpha)					, 
 		powx(rhs_orb.powx)						,
@@ -171,6 +175,7 @@ Iaorbital& Iaorbital::operator=(const Iaorbital& rhs_orb){
 		shell		= rhs_orb.shell;
 		gto			= rhs_orb.gto;
 		symmetry	= rhs_orb.symmetry;
+		ang			= rhs_orb.ang;
 		spherical	= rhs_orb.spherical;
 		n_factor	= rhs_orb.n_factor;
 		alpha		= rhs_orb.alpha;
@@ -185,8 +190,9 @@ Iaorbital& Iaorbital::operator=(const Iaorbital& rhs_orb){
 Iaorbital::Iaorbital(Iaorbital&& rhs_orb) noexcept :
 	shell(rhs_orb.shell)							,
 	gto(rhs_orb.gto)								,
-	symmetry( move(rhs_orb.symmetry) )				,
 	spherical( move(rhs_orb.spherical) )			,
+	symmetry( move(rhs_orb.symmetry) )				,
+	ang(rhs_orb.ang)								,
 	n_factor(rhs_orb.n_factor)						,
 	alpha(rhs_orb.alpha)							,
 	powx(rhs_orb.powx)								,
@@ -200,6 +206,7 @@ Iaorbital& Iaorbital::operator=(Iaorbital&& rhs_orb) noexcept {
 		shell		= rhs_orb.shell;
 		gto			= rhs_orb.gto;
 		symmetry	= move(rhs_orb.symmetry);
+		ang			= rhs_orb.ang;
 		spherical	= rhs_orb.spherical;
 		n_factor	= rhs_orb.n_factor;
 		alpha		= rhs_orb.alpha;
@@ -221,14 +228,42 @@ void Iaorbital::add_primitive(Iprimitive gorb){
 	gtos.emplace_back( move(gorb) );
 }
 /****************************************************************************************/
+void Iaorbital::set_ang_type(){
+	const string& sy = symmetry;
+	if 		( sy == "S" )											ang = ang_s;
+	else if	( sy == "PX" || sy == "PY" || sy == "PZ" )				ang = ang_p;
+	else if	( sy == "XX" || sy == "YY" || sy == "ZZ" )				ang = ang_d_sq;
+	else if	( sy == "XY" || sy == "YZ" || sy == "XZ" )				ang = ang_d_mix;
+	else if	( sy == "XXX" || sy == "YYY" || sy == "ZZZ" )			ang = ang_f_cube;
+	else if	( sy == "XXY" || sy == "YYX" || sy == "YYZ" || 
+			  sy == "XXZ" || sy == "XYY" || sy == "XZZ" )			ang = ang_f_sq;
+	else if	( sy == "XYZ" )											ang = ang_f_mix;
+	else if	( sy == "F7" )											ang = ang_f7;
+	else if	( sy == "D0" )											ang = ang_d0;
+	else if	( sy == "D1p" )											ang = ang_d1p;
+	else if	( sy == "D1n" )											ang = ang_d1n;
+	else if	( sy == "D2p" )											ang = ang_d2p;
+	else if	( sy == "D2n" )											ang = ang_d2n;
+	else if	( sy == "f0"  || sy == "F0"  )							ang = ang_f0;
+	else if	( sy == "f1p" || sy == "F1p" )							ang = ang_f1p;
+	else if	( sy == "f1n" || sy == "F1n" )							ang = ang_f1n;
+	else if	( sy == "f2p" || sy == "F2p" )							ang = ang_f2p;
+	else if	( sy == "f2n" || sy == "F2n" )							ang = ang_f2n;
+	else if	( sy == "f3p" || sy == "F3p" )							ang = ang_f3p;
+	else if	( sy == "f3n" || sy == "F3n" )							ang = ang_f3n;
+	else 															ang = ang_other;
+}
+/****************************************************************************************/
 bool Iaorbital::normalize(){
 	//m_log->input_message("Normalizing atomic orbitals!");
+	// the parsers set the symmetry after the construction
+	this->set_ang_type();
 	if (!gto){
 		double ff = 1.000000;
 		n_factor  = 0;
-		if 		( symmetry == "PX" || symmetry == "PY" || symmetry == "PZ" ) { ff = 3.000000; }
-		else if	( symmetry == "XX" || symmetry == "YY" || symmetry == "ZZ" ) { ff = 5.0000000/4.00000; } 
-		else if	( symmetry == "XY" || symmetry == "YZ" || symmetry == "XZ" ) { ff = 15.000000; } 
+		if 		( ang == ang_p )	 { ff = 3.000000; }
+		else if	( ang == ang_d_sq )	 { ff = 5.0000000/4.00000; } 
+		else if	( ang == ang_d_mix ) { ff = 15.000000; } 
 		double part1 = pow(2.0*alpha,(shell + 0.50));
 		double part2 = sqrt((ff/ (4.0*M_PI)));
 		double part3 = sqrt( factorial(2.0*shell) );
@@ -243,42 +278,59 @@ bool Iaorbital::normalize(){
 		double tmp_f3	= 4./(pow(3.,.5));
 		
 		for(unsigned int i=0;i<gtos.size();i++){
-			if 		( symmetry == "S" ) { 
-				gtos[i].n_fact = gtos[i].c_coef * pow(gtos[i].exponent,0.75) * 0.71270547;
-			}else if ( symmetry == "PX" || symmetry == "PY" || symmetry == "PZ" ){ 
-				gtos[i].n_fact =  gtos[i].c_coef * pow( gtos[i].exponent,1.25 ) * 1.425410941;
-			}else if ( symmetry == "XX" || symmetry == "YY" || symmetry == "ZZ"){
-				gtos[i].n_fact = gtos[i].c_coef * pow( gtos[i].exponent,1.75 ) * 1.645922781;
-			}else if ( symmetry == "XY" || symmetry == "YZ" || symmetry == "XZ"){
-				gtos[i].n_fact = gtos[i].c_coef * pow( gtos[i].exponent,1.75 ) * 2.850821881;
-			}else if ( symmetry == "XXX" || symmetry == "YYY" || symmetry == "ZZZ" ){
-				gtos[i].n_fact = gtos[i].c_coef * pow( gtos[i].exponent,2.25 ) * 1.47215808929;
-			}else if ( symmetry=="XXY" || symmetry=="YYX" || symmetry=="YYZ" || symmetry=="XXZ" || symmetry=="XYY" || symmetry=="XZZ"){
-				gtos[i].n_fact = gtos[i].c_coef * pow( gtos[i].exponent,2.25 ) * 3.2918455612;
-			}else if ( symmetry == "XYZ"){
-				gtos[i].n_fact = gtos[i].c_coef * pow( gtos[i].exponent,2.25 ) * 5.701643762;
-			}else if ( symmetry == "D0") {
-				gtos[i].n_fact = gtos[i].c_coef * pow(2048 * pow(gtos[i].exponent, 7.0)/(9.0 *M_PI*M_PI*M_PI),0.25);
-			}else if ( symmetry == "D1p" || symmetry == "D1n" || symmetry == "D2n" ){
-				gtos[i].n_fact = gtos[i].c_coef * pow(2048 * pow(gtos[i].exponent, 7.0)/(M_PI*M_PI*M_PI),0.25);
-			}else if ( symmetry == "D2p" ){
-				gtos[i].n_fact = gtos[i].c_coef * pow(128 * pow(gtos[i].exponent, 7.0)/(M_PI*M_PI*M_PI),0.25);
-			}else if ( symmetry == "F7"){
-				gtos[i].n_fact = gtos[i].c_coef * pow(gtos[i].exponent, 2.5) * 1.4721580892990935;
-			}else if ( symmetry == "F0" ){
-				gtos[i].n_fact = gtos[i].c_coef *  tmp_f0 * pow(gtos[i].exponent,2) * pow( (tmp * gtos[i].exponent),0.25 ); 
-			}else if ( symmetry == "F1p" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f1 * pow(gtos[i].exponent,2)  * pow( (tmp1 * gtos[i].exponent ),0.25);
-			}else if ( symmetry == "F1n" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f1 * pow(gtos[i].exponent,2)  * pow( (tmp1 * gtos[i].exponent ),0.25);
-			}else if ( symmetry == "F2p" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f2p * pow(gtos[i].exponent,2)  * pow( (tmp * gtos[i].exponent),0.25);
-			}else if ( symmetry == "F2n" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f2n * pow(gtos[i].exponent,2)  * pow( (tmp * gtos[i].exponent),0.25);
-			}else if ( symmetry == "F3p" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f3 * pow(gtos[i].exponent,2)  * pow( (tmp1 * gtos[i].exponent ),0.25);
-			}else if ( symmetry == "F3n" ){
-				gtos[i].n_fact = gtos[i].c_coef * tmp_f3 * pow(gtos[i].exponent,2)  * pow( (tmp1 * gtos[i].exponent),0.25);
+			double c_coef	= gtos[i].c_coef;
+			double expo		= gtos[i].exponent;
+			switch ( ang ){
+				case ang_s:
+					gtos[i].n_fact = c_coef * pow(expo,0.75) * 0.71270547;
+				break;
+				case ang_p:
+					gtos[i].n_fact = c_coef * pow( expo,1.25 ) * 1.425410941;
+				break;
+				case ang_d_sq:
+					gtos[i].n_fact = c_coef * pow( expo,1.75 ) * 1.645922781;
+				break;
+				case ang_d_mix:
+					gtos[i].n_fact = c_coef * pow( expo,1.75 ) * 2.850821881;
+				break;
+				case ang_f_cube:
+					gtos[i].n_fact = c_coef * pow( expo,2.25 ) * 1.47215808929;
+				break;
+				case ang_f_sq:
+					gtos[i].n_fact = c_coef * pow( expo,2.25 ) * 3.2918455612;
+				break;
+				case ang_f_mix:
+					gtos[i].n_fact = c_coef * pow( expo,2.25 ) * 5.701643762;
+				break;
+				case ang_d0:
+					gtos[i].n_fact = c_coef * pow(2048 * pow(expo, 7.0)/(9.0 *M_PI*M_PI*M_PI),0.25);
+				break;
+				case ang_d1p: case ang_d1n: case ang_d2n:
+					gtos[i].n_fact = c_coef * pow(2048 * pow(expo, 7.0)/(M_PI*M_PI*M_PI),0.25);
+				break;
+				case ang_d2p:
+					gtos[i].n_fact = c_coef * pow(128 * pow(expo, 7.0)/(M_PI*M_PI*M_PI),0.25);
+				break;
+				case ang_f7:
+					gtos[i].n_fact = c_coef * pow(expo, 2.5) * 1.4721580892990935;
+				break;
+				case ang_f0:
+					gtos[i].n_fact = c_coef * tmp_f0 * pow(expo,2) * pow( (tmp * expo),0.25 ); 
+				break;
+				case ang_f1p: case ang_f1n:
+					gtos[i].n_fact = c_coef * tmp_f1 * pow(expo,2) * pow( (tmp1 * expo ),0.25);
+				break;
+				case ang_f2p:
+					gtos[i].n_fact = c_coef * tmp_f2p * pow(expo,2) * pow( (tmp * expo),0.25);
+				break;
+				case ang_f2n:
+					gtos[i].n_fact = c_coef * tmp_f2n * pow(expo,2) * pow( (tmp * expo),0.25);
+				break;
+				case ang_f3p: case ang_f3n:
+					gtos[i].n_fact = c_coef * tmp_f3 * pow(expo,2) * pow( (tmp1 * expo ),0.25);
+				break;
+				default:
+				break;
 			}
 		}
 	}
@@ -16,21 +16,40 @@
 //------------------------------------------
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
+#include <cstring>
+#include <algorithm>
 //------------------------------------------
 #include "../include/common.h"
 #include "../include/log_class.h"
+#include "../include/Imapped_file.h"
 #include "../include/Iline.h"
 #include "../include/Ibuffer.h"
 //------------------------------------------
 using std::move;
 using std::string;
+using std::string_view;
 using std::vector;
 using std::cout;
 using std::endl;
-using std::ifstream;
 
+/*==============================================*/
+// end of the line starting at it, the line break itself or fin.
+static inline const char* line_end(const char* it, const char* fin){
+	if ( it >= fin ) return fin;
+	const char* eol = static_cast<const char*>( std::memchr(it,'\n',fin-it) );
+	return eol ? eol : fin;
+}
+/*==============================================*/
+// test if the first word of the line starts with wrd, without splitting the whole line.
+static inline bool first_word_is(const char* it, const char* eol, const string& wrd){
+	it = skip_blanks(it,eol);
+	const char* word = it;
+	while( it < eol && *it != ' ' && *it != '\t' && *it != '\r' ) ++it;
+	string_view first(word,it-word);
+	return first.size() > 0 && first.size() >= wrd.size() && first.compare(0,wrd.size(),wrd) == 0;
+}
 /*==============================================*/
 Ibuffer::Ibuffer()	:
 	nLines(0)		,
@@ -42,17 +61,19 @@ Ibuffer::Ibuffer(const char* file_name	,
 	nLines(0)							,
 	name(file_name)						{
 	
-	char tmp_line[500];
 	if ( parse ){
 		if ( IF_file(file_name) ){
-			ifstream buf(file_name);
-			name  = file_name;
-			while( !buf.eof() ){
-				buf.getline(tmp_line,500);
-				lines.emplace_back( tmp_line );
+			map.reset( new Imapped_file(file_name) );
+			const char* it  = map->begin();
+			const char* fin = map->end();
+			lines.reserve( std::count(it,fin,'\n') + 1 );
+			while( true ){
+				const char* eol = line_end(it,fin);
+				lines.emplace_back(it,eol);
 				nLines++;
+				if ( eol == fin ) break;
+				it = eol+1;
 			}
-			buf.close();
 			parsed = true;
 		}else{
 			string message = "Not possible to open the file: ";
@@ -65,13 +86,8 @@ Ibuffer::Ibuffer(const char* file_name	,
 	}else{
 		if ( IF_file(file_name) ){
 			m_log->input_message("Checking if the file can be pased and how many lines it has.");
-			ifstream buf(file_name);
-			name = file_name;
-			while( !buf.eof() ){
-				buf.getline(tmp_line,500);
-				nLines++;
-			}
-			buf.close();
+			Imapped_file file(file_name);
+			nLines = std::count(file.begin(),file.end(),'\n') + 1;
 		}else{
 			string message = "Not possible to open the file: ";
 			message += name;
@@ -91,20 +107,21 @@ Ibuffer::Ibuffer(const char* file_name	,
 	
 	int in_indx  = in;
 	int fin_indx = fin;
-	char tmp_line[500];
 	
 	if ( IF_file(file_name) ){
-		ifstream buf(file_name);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
+		map.reset( new Imapped_file(file_name) );
+		const char* it  = map->begin();
+		const char* end = map->end();
+		while( true ){
+			const char* eol = line_end(it,end);
 			if ( nLines > in_indx && nLines < fin_indx  ){
-				lines.emplace_back( move (tmp_line) );
+				lines.emplace_back(it,eol);
 			}
-			if ( nLines == fin_indx ) { break; }
-				nLines++;
+			if ( nLines == fin_indx || eol == end ) { break; }
+			nLines++;
+			it = eol+1;
 		}
 		nLines = lines.size();
-		buf.close();
 		parsed = true;
 	}else{
 		string message	= "Not possible to open the file: ";
@@ -123,28 +140,28 @@ Ibuffer::Ibuffer(const char* file_name	,
 	name(file_name)						{
 		
 	int in_indx  = -1;
-	int fin_indx = 0;
-	char tmp_line[500];
 		
 	if ( IF_file(file_name) ){
-		std::ifstream buf(file_name);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
-			Iline Line(tmp_line);
+		map.reset( new Imapped_file(file_name) );
+		const char* it  = map->begin();
+		const char* fin = map->end();
+		while( true ){
+			const char* eol = line_end(it,fin);
 			if ( in_indx == -1 ){
-				if ( Line.words[0].compare(0,wrdin.size(),wrdin) == 0  ){
+				if ( first_word_is(it,eol,wrdin) ){
 					in_indx = nLines;
-					lines.emplace_back( Line );
+					lines.emplace_back(it,eol);
 				}
 			}else if ( in_indx >= 0 ){
-				lines.emplace_back( Line );
-				if ( Line.IF_word( wrdfin,0,wrdfin.size() ) ) {
+				lines.emplace_back(it,eol);
+				if ( first_word_is(it,eol,wrdfin) ) {
 					break;
 				}
 			}
+			if ( eol == fin ) break;
 			nLines++;
+			it = eol+1;
 		}
-		buf.close();
 		nLines = lines.size();
 	}else{
 		string message = "Not possible to open the file: ";
@@ -163,50 +180,44 @@ Ibuffer::Ibuffer(const char* file_name		,
 	
 	int in_indx  = -1;
 	int fin_indx = 0;
-	char tmp_line[500];
 	
 	if ( IF_file(file_name) ){
-		ifstream buf(file_name);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
-			Iline Line (tmp_line);
+		map.reset( new Imapped_file(file_name) );
+		const char* it  = map->begin();
+		const char* fin = map->end();
+		const char* block = nullptr; // first line after the opening one.
+		while( fin_indx == 0 ){
+			const char* eol = line_end(it,fin);
 			if ( in_indx == -1 ){
 				for(unsigned int i=0;i<wrds_in.size(); i++){
-					if ( Line.IF_word( wrds_in[i],0,wrds_in[i].size() ) ) {
-						if ( in_indx == -1 ) 
-							in_indx = nLines;
+					if ( first_word_is(it,eol,wrds_in[i]) ) {
+						in_indx = nLines;
+						block	= eol;
+						break;
 					}
 				}
 			}
 			if ( in_indx >=0 ){
 				for(unsigned int j=0;j<wrds_fin.size();j++){
-					if ( Line.IF_word( wrds_fin[j],0,wrds_fin[j].size() ) ) {
-						if ( fin_indx == 0 ) 
-							fin_indx = nLines;
+					if ( first_word_is(it,eol,wrds_fin[j]) ) {
+						fin_indx = nLines;
 						break;
 					}
 				}
 			}
+			if ( eol == fin ) break;
 			nLines++;
+			it = eol+1;
 		}
-		if ( in_indx >=0 ){
-			buf.close();
-			ifstream buf2(file_name);
-			nLines = 0;
-			int real_nlines = 0;
-			while( !buf2.eof() ){
-				buf2.getline(tmp_line,500);
-				if ( nLines > in_indx && nLines < fin_indx  ){
-					lines.emplace_back( tmp_line );
-					real_nlines++;
-				}
-				if ( nLines == fin_indx ) {	break; }
+		nLines = 0;
+		if ( in_indx >=0 && fin_indx > in_indx+1 ){
+			it = block+1;
+			for( int n=in_indx+1; n<fin_indx; n++ ){
+				const char* eol = line_end(it,fin);
+				lines.emplace_back(it,eol);
 				nLines++;
+				it = eol+1;
 			}
-			nLines = real_nlines;
-			buf2.close();
-		}else{
-			nLines = 0;
 		}
 	}else{
 		string message = "Not possible to open the file: ";
@@ -226,21 +237,22 @@ Ibuffer& Ibuffer::get_block(int in, int fin){
 	}else{
 		if ( IF_file(name) ){
 			if ( in !=0 ){
-				ifstream buf(name);
+				map.reset( new Imapped_file(name) );
+				const char* it  = map->begin();
+				const char* end = map->end();
 				nLines = 0;
-				string tmp_line;
 				int real_nlines = 0;
-				while( !buf.eof() ){
-					getline(buf,tmp_line);
+				while( true ){
+					const char* eol = line_end(it,end);
 					if ( nLines > in && nLines < fin  ){
-						lines.emplace_back( move (tmp_line) );
+						lines.emplace_back(it,eol);
 						real_nlines++;
 					}
-					if ( nLines == fin ) {	break; }
+					if ( nLines == fin || eol == end ) {	break; }
 					nLines++;
+					it = eol+1;
 				}
 				nLines = real_nlines;
-				buf.close();
 				parsed = true;
 			}else{
 				nLines = 0;
@@ -25,15 +25,18 @@
 #include <iomanip>
 #include <omp.h>
 #include <algorithm>
+#include <charconv>
 
 //Including PRIMoRDiA headers
 #include "../include/common.h"
 #include "../include/Ibuffer.h"
 #include "../include/Iline.h"
+#include "../include/Imapped_file.h"
 #include "../include/log_class.h"
 #include "../include/Imolecule.h"
 #include "../include/Iatom.h"
 #include "../include/Icube.h"
+#include "../include/volume_file.h"
 
 using std::vector;
 using std::string;
@@ -42,6 +45,27 @@ using std::unique_ptr;
 using std::cout;
 using std::endl;
 
+/***************************************************************************/
+// parse the next number of the line in place, the pointer is advanced past it
+template<class T>
+static inline void read_value(const char*& it, const char* fin, T& val){
+	it = skip_blanks(it,fin);
+	auto res = std::from_chars(it,fin,val);
+	if ( res.ec == std::errc() ) it = res.ptr;
+}
+/***************************************************************************/
+// voxel value in the cube files: scientific notation with 6 decimals right aligned in
+// 16 columns followed by a blank
+static const unsigned int voxel_width = 17;
+static inline void write_voxel(double val, char* out){
+	char tmp[32];
+	auto res = std::to_chars(tmp,tmp+32,val,std::chars_format::scientific,6);
+	unsigned int len = res.ptr - tmp;
+	std::memset(out,' ',voxel_width-1-len);
+	std::memcpy(out+voxel_width-1-len,tmp,len);
+	out[voxel_width-1] = ' ';
+}
+
 /***************************************************************************/
 Icube::Icube()			:
 	name("dummyname")	,
@@ -71,71 +95,102 @@ Icube::Icube(const char* file_nam)	:
 		m_log->write_warning("The extension is not  .cube \n");
 	}
 	
-	int nof = 0;
-	
 	name = name.substr(0,name.size()-4);
 	
-	if ( IF_file(file_nam) ){
-		std::ifstream cube_file(file_nam);
-		if( cube_file.is_open() ) {
-			int line_len = 0;
-			while( !cube_file.eof() ){
-				string line;
-				getline(cube_file,line);
-				++line_len;
-			}
-			cube_file.clear();
-			cube_file.seekg(0,std::ios::beg);
-			
-			m_log->input_message( std::to_string(line_len) );
-			
-			for(int i=0;i<line_len;i++){
-				string line;
-				double dummy;
-				double temp;
-				getline(cube_file,line);
-				std::stringstream stream(line);
-			
-				if( i==0||i==1 ){
-					header += line;
-					header += "\n";
-				}else if( i==2 ){
-					stream  >> nof 	>> origin[0]  >> origin[1] >> origin[2];
-				}else if( i==3 ){
-					stream  >> grid[0]	>> gridsides[0];
-				}else if( i==4 ){
-					stream >> grid[1] >> dummy	>> gridsides[1]; 
-				}else if( i==5 ){
-					stream  >> grid[2] >> dummy  >> dummy >> gridsides[2];
-				}else if( i>5 && i<(6+nof) ){
-					Iatom  atom; 
-					stream >> atom.atomicN   >> dummy   >> atom.xcoord  >> atom.ycoord  >> atom.zcoord;
-					molecule.add_atom( atom );
-				}else if( i>(6+nof) ){
-					break;
-				}
-			}
-			voxelN = grid[0]*grid[1]*grid[2];
-			scalar.resize(voxelN);
-			cube_file.clear();
-			cube_file.seekg(0,std::ios::beg);
-			unsigned int count = 0;
-			for(unsigned int j=0;j<line_len;j++){
-				std::string line;
-				getline(cube_file,line);
-				if ( j >= 6+molecule.num_of_atoms){
-					double temp;
-					std::stringstream stream(line);
-					while( stream >> temp ){
-						scalar[count++] = temp;
-					}
-				}
-			}
-		}else{
-			cout << "File is not open, Icube instance not initialized" << endl;
-		}
-	}else{
+	if ( !IF_file(file_nam) ){
 		cout << "Error in openning the cube file: " << file_nam << endl;
+		return;
+	}
+	Imapped_file cube_file(file_nam);
+	if ( !cube_file.is_open() ){
+		cout << "File is not open, Icube instance not initialized" << endl;
+		return;
+	}
+	const char* it	= cube_file.begin();
+	const char* fin	= cube_file.end();
+	//reading the header lines in place
+	for( int i=0; i<2; i++ ){
+		const char* eol = next_line(it,fin);
+		header.append(it,eol-it);
+		if ( header.empty() || header.back() != '\n' ) header += "\n";
+		it = eol;
+	}
+	int nof = 0;
+	double dummy;
+	const char* line = it;
+	read_value(line,fin,nof);
+	for( int i=0; i<3; i++ ) read_value(line,fin,origin[i]);
+	it = next_line(it,fin);
+	for( int i=0; i<3; i++ ){
+		line = it;
+		read_value(line,fin,grid[i]);
+		for( int j=0; j<3; j++ ){
+			if ( j == i ) read_value(line,fin,gridsides[i]);
+			else read_value(line,fin,dummy);
+		}
+		it = next_line(it,fin);
+	}
+	Imolecule mol;
+	for( int i=0; i<nof; i++ ){
+		Iatom atom;
+		line = it;
+		read_value(line,fin,atom.atomicN);
+		read_value(line,fin,dummy);
+		read_value(line,fin,atom.xcoord);
+		read_value(line,fin,atom.ycoord);
+		read_value(line,fin,atom.zcoord);
+		mol.add_atom( atom );
+		it = next_line(it,fin);
+	}
+	molecule = std::make_shared<const Imolecule>( move(mol) );
+	voxelN = grid[0]*grid[1]*grid[2];
+	scalar.resize(voxelN);
+	
+	//the voxel block is split in chunks starting at line beginnings, the values in each
+	//chunk are counted to get its first voxel index and then parsed in parallel
+	const std::size_t min_chunk = 1 << 16;
+	std::size_t data_len	= fin - it;
+	unsigned int nchunks	= std::max<std::size_t>( 1, std::min<std::size_t>( NP, data_len/min_chunk ) );
+	vector<const char*> bounds(nchunks+1);
+	bounds[0]		= it;
+	bounds[nchunks]	= fin;
+	for( unsigned int k=1; k<nchunks; k++ ){
+		bounds[k] = std::max( bounds[k-1], next_line(it + k*(data_len/nchunks),fin) );
+	}
+	vector<unsigned int> first(nchunks+1,0);
+	omp_set_num_threads(NP);
+	#pragma omp parallel for
+	for( unsigned int k=0; k<nchunks; k++ ){
+		unsigned int cnt = 0;
+		bool blank = true;
+		for( const char* c=bounds[k]; c<bounds[k+1]; c++ ){
+			bool b = ( *c == ' ' || *c == '\n' || *c == '\t' || *c == '\r' );
+			if ( blank && !b ) cnt++;
+			blank = b;
+		}
+		first[k+1] = cnt;
+	}
+	for( unsigned int k=0; k<nchunks; k++ ) first[k+1] += first[k];
+	unsigned int bad_values = 0;
+	#pragma omp parallel for reduction(+:bad_values)
+	for( unsigned int k=0; k<nchunks; k++ ){
+		unsigned int count	= first[k];
+		const char* c		= bounds[k];
+		const char* cfin	= bounds[k+1];
+		while( count < voxelN ){
+			while( c < cfin && ( *c == ' ' || *c == '\n' || *c == '\t' || *c == '\r' ) ) ++c;
+			if ( c == cfin ) break;
+			auto res = std::from_chars(c,cfin,scalar[count++]);
+			if ( res.ec != std::errc() ){
+				scalar[count-1] = 0.0;
+				bad_values++;
+				while( c < cfin && !( *c == ' ' || *c == '\n' || *c == '\t' || *c == '\r' ) ) ++c;
+			}else c = res.ptr;
+		}
+	}
+	if ( first[nchunks] != voxelN || bad_values > 0 ){
+		cout << "Warning! The voxel data of the cube file " << file_nam << " does not match its grid\n";
+		m_log->write_warning("The voxel data of the cube file does not match its grid: " + string(file_nam) + " \n");
 	}
 }
 /***************************************************************************/
@@ -180,7 +235,7 @@ Icube::Icube(Icube&& rhs_cube) noexcept	:
 		MOn(rhs_cube.MOn)				, 
 		voxelN(rhs_cube.voxelN)			,
 		header(rhs_cube.header)			,
-		molecule( move(rhs_cube.molecule) ),
+		molecule( move(rhs_cube.molecule) )	,
 		scalar( move(rhs_cube.scalar) )	{
 
 		for(int i=0;i<3;i++){
@@ -226,71 +281,6 @@ bool operator==(const Icube& lhs_cube,const Icube& rhs_cube){
 	return result;
 }  
 /***************************************************************************/
-Icube operator-(const Icube& lhs_cube, const Icube& rhs_cube){
-	Icube Result(lhs_cube);
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] -= rhs_cube.scalar[x]; }
-	return Result;
-} 
-/***************************************************************************/
-Icube operator+(const Icube& lhs_cube, const Icube& rhs_cube){	
-	Icube Result(lhs_cube);
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] += rhs_cube.scalar[x]; }
-	return Result;
-}
-/***************************************************************************/
-Icube operator*(const Icube& lhs_cube, const  Icube& rhs_cube){
-	Icube Result(lhs_cube);
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] *= rhs_cube.scalar[x] ;}
-	return Result;
-}
-/***************************************************************************/
-Icube operator/(const Icube& lhs_cube, const Icube& rhs_cube){
-	Icube Result(lhs_cube);
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) {
-		if ( rhs_cube.scalar[x] == 0.00 ) Result.scalar[x] = 1000.0;
-		else Result.scalar[x] /= rhs_cube.scalar[x]; 
-	}
-	return Result;
-}
-/***************************************************************************/
-Icube operator-(const Icube& lhs_cube, double value){
-	Icube Result(lhs_cube);
-	
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] -=  value; } 
-	return Result;	
-}
-/***************************************************************************/
-Icube operator+(const Icube& lhs_cube, double value){
-	Icube Result(lhs_cube);
-	
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] +=  value; }
-	return Result;	
-}
-/***************************************************************************/
-Icube operator*(const Icube& lhs_cube, double value){
-	Icube Result(lhs_cube);
-	for(unsigned int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] *=  value; }
-	return Result;	
-}
-/***************************************************************************/
-Icube operator/(const Icube& lhs_cube, double value){
-	Icube Result(lhs_cube);
-	for(int x=0;x<lhs_cube.voxelN;x++) { Result.scalar[x] /= value; }
-	return Result;
-}
-/***************************************************************************/
-Icube Icube::scale_cube(double val){
-	Icube Result(*this);	
-	for(int x=0;x<voxelN;x++) { Result.scalar[x] = pow(scalar[x],val); }
-	return Result;
-}
-/***************************************************************************/
-Icube Icube::SQ(){ 
-	Icube Result(*this);
-	for(int x=0;x<voxelN;x++) { Result.scalar[x] = this->scalar[x]*this->scalar[x]; }
-	return Result;
-}
-/***************************************************************************/
 double Icube::calc_cube_integral(){
 	double integral = 0;
 	for (int i=0;i<voxelN;i++) { integral += scalar[i]; }
@@ -331,14 +321,6 @@ double Icube::similarity_index(Icube& cube,string type){
 	return result;
 }
 /***************************************************************************/
-Icube Icube::log_cube(){
-	Icube result(*this);
-	omp_set_num_threads(NP);
-	#pragma omp parallel for
-	for(unsigned int i=0;i<voxelN;i++) { result.scalar[i] = log(this->scalar[i]);}
-	return result;
-}
-/***************************************************************************/
 Icube Icube::calculate_complement(bool clog ){
 	Icube complement(*this);
 	complement.name   = name + "complement_log";
@@ -368,9 +350,25 @@ void Icube::add_data(vector<vector<vector<double> > >& data){
 	}
 }
 /***************************************************************************/
+void Icube::set_grid(const Icube& ref){
+	elec_dens	= ref.elec_dens;
+	MOn			= ref.MOn;
+	voxelN		= ref.voxelN;
+	molecule	= ref.molecule;
+	for(int i=0;i<3;i++){
+		origin[i]		= ref.origin[i];
+		gridsides[i]	= ref.gridsides[i];
+		grid[i]			= ref.grid[i];
+	}
+	scalar.resize(voxelN);
+}
+/***************************************************************************/
 void Icube::write_cube(string cubeName){
-	std::ofstream cube_file;
-	cube_file.open(cubeName.c_str());
+	this->write_cube(cubeName,NP);
+}
+/***************************************************************************/
+void Icube::write_cube(string cubeName, int nthr){
+	std::ostringstream cube_file;
 	cube_file.precision(6);
 	cube_file << std::fixed;
 	
@@ -378,13 +376,14 @@ void Icube::write_cube(string cubeName){
 	if ( elec_dens ) cube_type = "Total Electronic Density ";
 	else cube_type = "Molecular Orbital ";
 	
+	unsigned int nat = molecule ? molecule->num_of_atoms : 0;
 	if ( header == "" ){
 		header =  "Cube file written by Icube class created by Igor Barden Grillo igorChem on github\n";
 		header +=  cube_type + "for "  + name + "\n";
 	}
 		
 	cube_file << header
-			  << std::setw(5)  << std::right << molecule.num_of_atoms
+			  << std::setw(5)  << std::right << nat
 			  << "  " 
 			  << std::setw(12) << std::right << origin[0] 
 			  << "  " 
@@ -419,27 +418,35 @@ void Icube::write_cube(string cubeName){
 	
 	if ( elec_dens == false ) cube_file << "    1    " << MOn << "\n"; 
 
-	for (int i=0; i<molecule.num_of_atoms;i++){
-		cube_file << std::setw(5)  << std::right << molecule.atoms[i].atomicN 
+	for (int i=0; i<nat;i++){
+		cube_file << std::setw(5)  << std::right << molecule->atoms[i].atomicN 
 				  << "   " 
-				  << std::setw(4)  << std::right << molecule.atoms[i].atomicN
+				  << std::setw(4)  << std::right << molecule->atoms[i].atomicN
 				  << "   " 
-				  << std::setw(12) << std::right << molecule.atoms[i].xcoord
+				  << std::setw(12) << std::right << molecule->atoms[i].xcoord
 				  << "   " 
-				  << std::setw(12) << std::right << molecule.atoms[i].ycoord
+				  << std::setw(12) << std::right << molecule->atoms[i].ycoord
 				  << "   " 
-				  << std::setw(12) << std::right << molecule.atoms[i].zcoord
+				  << std::setw(12) << std::right << molecule->atoms[i].zcoord
 				  << "\n";
 	}
 	
-	cube_file.precision(6);
-	cube_file << std::scientific;
 	
+	//each voxel value takes a fixed number of characters, so its place in the output block
+	//is known in advance and the values are formatted in parallel
+	std::size_t nbytes = std::size_t(voxelN)*voxel_width + voxelN/6;
+	vector<char> block(nbytes);
+	#pragma omp parallel for num_threads(nthr)
 	for(unsigned int x=0;x<voxelN;x++){
-		cube_file << std::setw(16) << scalar[x] << " " ;
-		if ( x%6==5 ) cube_file << "\n";
-	}	
-	cube_file.close();
+		char* out = &block[ std::size_t(x)*voxel_width + x/6 ];
+		write_voxel(scalar[x],out);
+		if ( x%6==5 ) out[voxel_width] = '\n';
+	}
+	std::ofstream file(cubeName.c_str());
+	string top = cube_file.str();
+	file.write(top.data(),top.size());
+	file.write(block.data(),block.size());
+	file.close();
 }
 /***************************************************************************/
 void Icube::get_cube_stats(double& mean, double& min, double& max){
@@ -450,7 +457,7 @@ void Icube::get_cube_stats(double& mean, double& min, double& max){
 /***************************************************************************/
 void Icube::print(){
 	cout << name << endl;
-	cout << molecule.num_of_atoms << endl;
+	if ( molecule ) cout << molecule->num_of_atoms << endl;
 	for(int i=0;i<3;i++){
 		cout << "Origin for "			<< i << " dimension: " << origin[i] << endl; 
 		cout << "Number of points for "	<< i << " dimension: " << grid[i]   << endl; 
@@ -467,12 +474,12 @@ Icube::~Icube(){
 //**************************************************/
 cube_diffs::cube_diffs(const char* name){	
 	unique_ptr<Ibuffer> file ( new Ibuffer(name,true) );
-	unsigned int size = stoi( file->lines[0].words[0] );
+	unsigned int size = file->lines[0].get_int(0);
 	for ( unsigned int i = 1; i<size+1; i++ ) {
-		const char* cub1name = file->lines[i].words[0].c_str();
-		const char* cub2name = file->lines[i].words[1].c_str();
-		Icube cub1(cub1name);
-		Icube cub2(cub2name);
+		string cub1name = file->lines[i].get_string(0);
+		string cub2name = file->lines[i].get_string(1);
+		Icube cub1 = load_cube( cub1name.c_str() );
+		Icube cub2 = load_cube( cub2name.c_str() );
 		double val = cub1.similarity_index(cub2,"default");
 		diffs.push_back(val);
 		labels.push_back(cub1.name + "__" + cub2.name);
@@ -15,60 +15,68 @@
  
 #include <iostream>
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <vector>
+#include <charconv>
+#include <stdexcept>
 //--------------------------------------
 #include "../include/common.h"
 #include "../include/log_class.h"
+#include "../include/Imapped_file.h"
 #include "../include/Iline.h"
 //--------------------------------------
 using std::string;
+using std::string_view;
 using std::move;
-using std::stod;
-using std::stoi;
+//=====================================================
+// convert a word to a number as stoi/stod do, accepting a leading plus sign.
+template<typename T>
+static inline bool read_word(string_view word, T& val){
+	const char* it  = word.data();
+	const char* fin = it + word.size();
+	if ( it < fin && *it == '+' ) ++it;
+	return std::from_chars(it,fin,val).ec == std::errc();
+}
 //=====================================================
 Iline::Iline()			:
 	line_len(0)			{
-	words.reserve(50);
 }
 /*****************************************************************************/
-Iline::Iline(string Line):
-	line_len(0)				{
-		
-	words.reserve(30);
-	std::stringstream stream(Line);
-	string word;
-	word.reserve(20);
+Iline::Iline(const char* first	,
+			 const char* last)	:
+	line_len(0)					{
 	
-	while (stream >> word){
-		words.emplace_back( word );
-		line_len++;
-	}
+	tokenize(first,last);
+}
+/*****************************************************************************/
+Iline::Iline(string Line)	:
+	line_len(0)				,
+	text( move(Line) )		{
+		
+	tokenize( text.data(), text.data()+text.size() );
 }
 /*****************************************************************************/
 Iline::Iline(char* Line)	:
-	line_len(0)				{
+	line_len(0)				,
+	text(Line)				{
 		
-	words.reserve(30);
-	std::stringstream stream(Line);
-	string word;
-	word.reserve(20);
-	
-	while (stream >> word){
-		words.emplace_back( word );
-		line_len++;
-	}
+	tokenize( text.data(), text.data()+text.size() );
 }
 /*****************************************************************************/
 Iline::Iline(const Iline& rhs_line)	:
 	words(rhs_line.words)			,
-	line_len(rhs_line.line_len)		{
+	line_len(rhs_line.line_len)		,
+	text(rhs_line.text)				{
+	
+	if ( !text.empty() ) rebase( rhs_line.text.data() );
 }
 /*****************************************************************************/
 Iline& Iline::operator=(const Iline& rhs_line){
 	if( this != &rhs_line ){
 		words	= rhs_line.words;
 		line_len= rhs_line.line_len;
+		text	= rhs_line.text;
+		if ( !text.empty() ) rebase( rhs_line.text.data() );
 	}
 	return *this;
 }
@@ -76,16 +84,42 @@ Iline& Iline::operator=(const Iline& rhs_line){
 Iline::Iline(Iline&& rhs_line) noexcept	:
 	words( move(rhs_line.words) )		,
 	line_len( rhs_line.line_len)		{
+	
+	const char* old_text = rhs_line.text.data();
+	text = move(rhs_line.text);
+	if ( !text.empty() ) rebase(old_text);
 }
 /*****************************************************************************/
 Iline& Iline::operator=(Iline&& rhs_line) noexcept {
 	if( this != &rhs_line ){
+		const char* old_text = rhs_line.text.data();
 		words	= move(rhs_line.words);
 		line_len	= rhs_line.line_len;
+		text	= move(rhs_line.text);
+		if ( !text.empty() ) rebase(old_text);
 	}
 	return *this;
 }
 /*****************************************************************************/
+void Iline::tokenize(const char* it, const char* fin){
+	words.clear();
+	while( true ){
+		it = skip_blanks(it,fin);
+		if ( it >= fin || *it == '\n' ) break;
+		const char* word = it;
+		while( it < fin && *it != ' ' && *it != '\t' && *it != '\r' && *it != '\n' ) ++it;
+		words.emplace_back( word, it-word );
+	}
+	line_len = words.size();
+}
+/*****************************************************************************/
+void Iline::rebase(const char* old_text){
+	// the words keep their offsets in the line, only the storage changed.
+	for( auto& word: words ){
+		word = string_view( text.data() + ( word.data() - old_text ), word.size() );
+	}
+}
+/*****************************************************************************/
 bool Iline::IF_word(string& s, unsigned  pos){
 	if ( line_len == 0 || pos > line_len-1 ){
 		return false;
@@ -123,21 +157,20 @@ bool Iline::IF_line(string s1, int pos1,string  s2, int pos2, int len){
 /*****************************************************************************/
 string Iline::get_line(){
 	string line = "";
-	for(unsigned int i=0;i<words.size();i++){ line += words[i] + " "; }
+	for(unsigned int i=0;i<words.size();i++){ line.append(words[i]); line += ' '; }
 	return line;
 }
 /*****************************************************************************/
 int Iline::pop_int(int pos){
-	int res = stoi(words[pos]);
+	int res = 0;
+	if ( !read_word(words[pos],res) ) throw std::invalid_argument("pop_int");
 	words.erase( words.begin()+pos );
 	return res;
 }
 /*****************************************************************************/
 int Iline::get_int(int pos){ 
 	int res = 0;
-	try{
-		res = stoi(words[pos]);
-	}catch( const std::invalid_argument& ){
+	if ( !read_word(words[pos],res) ){
 		std::cout << "Impossible to convert to an integer!" << std::endl;
 		m_log->write_error("In convert some string to int!\n verify you input file, error may be in the position of an argument!\n");
 		m_log->input_message("The problematic line is: \n\t");
@@ -147,16 +180,15 @@ int Iline::get_int(int pos){
 }
 /*****************************************************************************/
 double Iline::pop_double(int pos){
-	double res = stod(words[pos] );
+	double res = 0.0;
+	if ( !read_word(words[pos],res) ) throw std::invalid_argument("pop_double");
 	words.erase( words.begin()+pos );
 	return res;
 }
 /*****************************************************************************/
 double Iline::get_double(int pos){
 	double res = 0.000;
-	try{
-		res = stod(words[pos]);
-	}catch( const std::invalid_argument& ){
+	if ( !read_word(words[pos],res) ){
 		std::cout << "Impossible to convert to double!" << std::endl;
 		m_log->write_error("In convert some string to int!\n verify you input file, error may be in the position of an argument!\n");
 		m_log->input_message("The problematic line is: \n\t");
@@ -175,12 +207,12 @@ double Iline::pop_double_f(int pos){
 double Iline::get_double_f(int pos){ return D_E_conv( words[pos] ); }
 /*****************************************************************************/
 string Iline::pop_string(int pos){
-	string res = words[pos];
+	string res( words[pos] );
 	words.erase( words.begin()+pos );
 	return res;
 }
 /*****************************************************************************/
-string& Iline::get_string(int pos){ return words[pos]; }
+string Iline::get_string(int pos){ return string( words[pos] ); }
 /*****************************************************************************/
 void Iline::print(){
 	for(unsigned int i=0; i<words.size();i++){
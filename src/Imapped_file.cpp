@@ -0,0 +1,77 @@
+//Imapped_file.cpp
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+//------------------------------------------
+#include <cstddef>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//------------------------------------------
+#include "../include/Imapped_file.h"
+//------------------------------------------
+
+/*==============================================*/
+Imapped_file::Imapped_file(const char* file_name)	:
+	data(nullptr)									,
+	size(0)											,
+	handle(nullptr)									{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(file_name,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+	if ( file == INVALID_HANDLE_VALUE ) return;
+	LARGE_INTEGER fsize;
+	if ( GetFileSizeEx(file,&fsize) && fsize.QuadPart > 0 ){
+		HANDLE map = CreateFileMappingA(file,NULL,PAGE_READONLY,0,0,NULL);
+		if ( map != NULL ){
+			data = static_cast<const char*>( MapViewOfFile(map,FILE_MAP_READ,0,0,0) );
+			if ( data ){
+				size	= static_cast<std::size_t>(fsize.QuadPart);
+				handle	= map;
+			}else CloseHandle(map);
+		}
+	}
+	CloseHandle(file);
+#else
+	int fd = open(file_name,O_RDONLY);
+	if ( fd < 0 ) return;
+	struct stat st;
+	if ( fstat(fd,&st) == 0 && st.st_size > 0 ){
+		void* addr = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if ( addr != MAP_FAILED ){
+			madvise(addr,st.st_size,MADV_SEQUENTIAL);
+			data = static_cast<const char*>(addr);
+			size = static_cast<std::size_t>(st.st_size);
+		}
+	}
+	close(fd);
+#endif
+}
+/******************************************************************/
+Imapped_file::~Imapped_file(){
+	if ( !data ) return;
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle( static_cast<HANDLE>(handle) );
+#else
+	munmap( const_cast<char*>(data), size );
+#endif
+}
+//================================================================================
+//END OF FILE
+//================================================================================
@@ -99,7 +99,11 @@ Imolecule::Imolecule(const Imolecule& rhs_molecule)		:
 	m_overlap(rhs_molecule.m_overlap)					,
 	occupied(rhs_molecule.occupied)						,
 	occupied_beta(rhs_molecule.occupied_beta)			,
-	atoms(rhs_molecule.atoms)							{
+	atoms(rhs_molecule.atoms)							,
+	ao_offset(rhs_molecule.ao_offset)					,
+	lmo_first(rhs_molecule.lmo_first)					,
+	lmo_ao(rhs_molecule.lmo_ao)							,
+	lmo_coeff(rhs_molecule.lmo_coeff)					{
 	
 	for(int i=0;i<3;i++) {
 		dipole_moment[i]	= rhs_molecule.dipole_moment[i];
@@ -141,6 +145,10 @@ Imolecule& Imolecule::operator=(const Imolecule& rhs_molecule){
 		occupied			= rhs_molecule.occupied;
 		occupied_beta		= rhs_molecule.occupied_beta;
 		atoms				= rhs_molecule.atoms;
+		ao_offset			= rhs_molecule.ao_offset;
+		lmo_first			= rhs_molecule.lmo_first;
+		lmo_ao				= rhs_molecule.lmo_ao;
+		lmo_coeff			= rhs_molecule.lmo_coeff;
 		
 		for(int i=0;i<3;i++) {
 			dipole_moment[i] 	= rhs_molecule.dipole_moment[i];
@@ -181,7 +189,11 @@ Imolecule::Imolecule(Imolecule&& rhs_molecule) noexcept			:
 	m_overlap( move(rhs_molecule.m_overlap) )					,
 	occupied( move(rhs_molecule.occupied))						,
 	occupied_beta( move(rhs_molecule.occupied_beta) )			,
-	atoms( move(rhs_molecule.atoms) )							{
+	atoms( move(rhs_molecule.atoms) )							,
+	ao_offset( move(rhs_molecule.ao_offset) )					,
+	lmo_first( move(rhs_molecule.lmo_first) )					,
+	lmo_ao( move(rhs_molecule.lmo_ao) )							,
+	lmo_coeff( move(rhs_molecule.lmo_coeff) )					{
 	
 	for(int i = 0 ; i < 3; i++) {
 		dipole_moment[i]= rhs_molecule.dipole_moment[i];
@@ -222,6 +234,10 @@ Imolecule& Imolecule::operator=(Imolecule&& rhs_molecule) noexcept {
 		occupied			= move(rhs_molecule.occupied);
 		occupied_beta		= move(rhs_molecule.occupied_beta);
 		atoms				= move(rhs_molecule.atoms);
+		ao_offset			= move(rhs_molecule.ao_offset);
+		lmo_first			= move(rhs_molecule.lmo_first);
+		lmo_ao				= move(rhs_molecule.lmo_ao);
+		lmo_coeff			= move(rhs_molecule.lmo_coeff);
 		
 		for(int i = 0 ; i < 3; i++) {
 			dipole_moment[i]= rhs_molecule.dipole_moment[i];
@@ -303,12 +319,27 @@ vector<double> Imolecule::extract_MO(int MO,bool beta){
 	vector<double> res_mo(nMO);
 
 	for (int i=0;i<nMO;i++){
-		if ( !beta ) res_mo[i] = coeff_MO[MO*MOnmb+i];
+		if ( sparse_MO() && !beta ) res_mo[i] = this->get_coeff(MO,i);
+		else if ( !beta ) res_mo[i] = coeff_MO[MO*MOnmb+i];
 		else         res_mo[i] = coeff_MO_beta[MO*MOnmb_beta+i];
 	}
 	return res_mo;
 }
 /***************************************************************************************/
+bool Imolecule::sparse_MO() const{
+	return lmo_first.size() > 1;
+}
+/***************************************************************************************/
+double Imolecule::get_coeff(unsigned int MO, unsigned int ao) const{
+	if ( !this->sparse_MO() ) return coeff_MO[MO*num_of_ao+ao];
+	// the atomic orbitals of each localized MO are stored in ascending order
+	auto first	= lmo_ao.begin() + lmo_first[MO];
+	auto last	= lmo_ao.begin() + lmo_first[MO+1];
+	auto it		= std::lower_bound(first,last,ao);
+	if ( it == last || *it != ao ) return 0.0;
+	return lmo_coeff[it - lmo_ao.begin()];
+}
+/***************************************************************************************/
 void Imolecule::print(){
 	cout << "Molecule's name: " << name << endl;
 	this->print_coordinates();
@@ -321,7 +352,7 @@ void Imolecule::print(){
 	for (unsigned int o=0;o<num_of_atoms;o++) atoms[o].print();
 	for (unsigned int i=0;i<orb_energies.size();i++) {
 		cout	<< orb_energies[i]	<< " " 
-				<< coeff_MO[i]	<< " " 
+				<< this->get_coeff(0,i)	<< " " 
 				<< m_overlap[i] << " "
 				<< occupied[i] 	<< endl;
 	}
@@ -366,6 +397,12 @@ int Imolecule::get_ao_number(){
 	return num_of_ao;
 }
 /***************************************************************************************/
+void Imolecule::set_ao_offset(){
+	ao_offset.resize(atoms.size()+1);
+	ao_offset[0] = 0;
+	for(unsigned int i=0;i<atoms.size();i++) ao_offset[i+1] = ao_offset[i] + atoms[i].orbitals.size();
+}
+/***************************************************************************************/
 double Imolecule::get_homo(){
 	int homo_nalfa = homoN;
 	int homo_nbeta = homoN;
@@ -432,6 +469,45 @@ double Imolecule::get_lumo(){
 	return lumo_energy;
 }
 /***************************************************************************************/
+unsigned int Imolecule::lumo_index() const{
+	// same electron count that update() sets, the formal charge taken from the atomic charges.
+	int noe			= num_of_electrons;
+	double chg		= 0.0;
+	if ( noe == 0 ){
+		for(unsigned int i=0;i<atoms.size();i++) noe += atoms[i].atomicN;
+	}
+	for(unsigned int i=0;i<atoms.size();i++) chg += atoms[i].charge;
+	if ( !betad || noe % 2 == 0 ) noe += -1*int( std::round(chg) );
+	if ( noe < 0 ) noe = 0;
+	unsigned int lumo = (noe+1)/2;
+	// update() keeps the occupations some parsers read from the file
+	for(unsigned int i=0;i<occupied.size();i++) if ( occupied[i] >= 1 ) lumo = std::max(lumo,i+1);
+	for(unsigned int i=0;i<occupied_beta.size();i++) if ( occupied_beta[i] >= 1 ) lumo = std::max(lumo,i+1);
+	return lumo;
+}
+/***************************************************************************************/
+unsigned int Imolecule::MO_window(const vector<double>& energies, int band, double conv) const{
+	// the window holds the occupied MOs, the band after the LUMO and the virtual MOs inside the
+	// energy criteria, the energy weighted grids taking weights above 0.36. The atomic charges
+	// must be stored before, they shift the LUMO. conv converts the energies to eV.
+	unsigned int nmo	= energies.size();
+	unsigned int lumo	= this->lumo_index();
+	if ( band < 0 || lumo+1 >= nmo ) return nmo;
+	double window	= std::max( std::abs(energy_crit), -std::log(0.36) )/conv;
+	unsigned int n	= std::min( lumo+band+2, nmo );
+	while ( n < nmo && energies[n] <= energies[lumo] + window ) n++;
+	return n;
+}
+/***************************************************************************************/
+bool Imolecule::MO_loaded(int band) const{
+	// true if the stored coefficients reach the band after the LUMO found by update().
+	if ( band < 0 || num_of_ao == 0 || this->sparse_MO() ) return true;
+	unsigned int need = std::max(lumoN,0) + band + 2;
+	if ( coeff_MO.size()/num_of_ao < std::min(need,MOnmb) ) return false;
+	if ( betad && coeff_MO_beta.size()/num_of_ao < std::min(need,MOnmb_beta) ) return false;
+	return true;
+}
+/***************************************************************************************/
 void Imolecule::print_basis(){
 	for(unsigned int i=0;i<atoms.size();i++){
 		for(unsigned int j=0;j<atoms[i].orbitals.size();j++) atoms[i].orbitals[j].print();
@@ -455,6 +531,7 @@ void Imolecule::update(){
 	f_chg			= std::round(mol_charge);
 	num_of_atoms	= atoms.size();
 	this->get_ao_number();
+	this->set_ao_offset();
 	unsigned int noe= num_of_electrons;
 	int i;
 	if ( !betad ){
@@ -497,6 +574,9 @@ void Imolecule::clear(){
 	vector<double>().swap(orb_energies_beta);
 	vector<double>().swap(coeff_MO);
 	vector<double>().swap(coeff_MO_beta);
+	vector<unsigned int>().swap(lmo_first);
+	vector<unsigned int>().swap(lmo_ao);
+	vector<double>().swap(lmo_coeff);
 	vector<double>().swap(m_dens);
 	vector<double>().swap(beta_dens);
 	vector<double>().swap(m_overlap);
@@ -525,10 +605,14 @@ bool Imolecule::check(){
 		m_log->write_warning("Zero atomic orbitals parsed from file for this molecule!"); 
 		all_ok = false;
 	}
-	if ( coeff_MO.size() == 0 ){
+	if ( coeff_MO.size() == 0 && !this->sparse_MO() ){
 		m_log->write_warning("Molecular orbitals coeffcients not stored"); 
 		all_ok = false;
 	}
+	if ( num_of_ao > 0 && coeff_MO.size() > 0 && coeff_MO.size()/num_of_ao <= (unsigned)std::max(lumoN,0) ){
+		m_log->write_warning("Molecular orbitals coeffcients not loaded up to the LUMO");
+		all_ok = false;
+	}
 	if ( orb_energies.size() == 0 || MOnmb == 0) {
 		m_log->write_warning("Molecular orbitals energies not stored");  
 		all_ok = false;
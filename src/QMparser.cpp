@@ -44,20 +44,40 @@ using std::string;
 QMparser::QMparser()	:
 	program("none")		,
 	name_f("none")		,
-	parsed(false)		{
+	parsed(false)		,
+	mo_band(-1)			{
 }
 /************************************************************************************/
 QMparser::QMparser(const char* file_name,
 								string Program			):
 	program(Program)									,
-	name_f(file_name)									{
+	name_f(file_name)									,
+	mo_band(-1)											{
+}
+/************************************************************************************/
+QMparser::QMparser(const char* file_name,
+								string Program			,
+								int band				):
+	program(Program)									,
+	name_f(file_name)									,
+	mo_band(band)										{
 }
 /************************************************************************************/
 Imolecule QMparser::get_molecule(){
+	Imolecule molecule = this->parse_file(mo_band);
+	if ( !molecule.MO_loaded(mo_band) ){
+		m_log->write_warning("Molecular orbitals coeffcients not loaded up to the frontier band, parsing the file again with all of them!");
+		molecule = this->parse_file(-1);
+	}
+	return molecule;
+}
+/**********************************************************************************/
+Imolecule QMparser::parse_file(int band){
 	Imolecule empty_molecule;
 	empty_molecule.name = "empty";
 	if ( program == "mopac" ){
 		mopac_files file_obj(name_f);
+		file_obj.mo_band = band;
 		if ( file_obj.is_open ){
 			if ( file_obj.type == "AUX" ){
 				file_obj.parse_aux();
@@ -75,6 +95,7 @@ Imolecule QMparser::get_molecule(){
 		}
 	}else if (program == "gamess"){
 		gamess_files file_obj(name_f);
+		file_obj.mo_band = band;
 		if ( file_obj.is_open ){
 			file_obj.parse_log();
 			return file_obj.molecule;
@@ -84,6 +105,7 @@ Imolecule QMparser::get_molecule(){
 		}
 	}else if (program == "orca"){
 		orca_files file_obj(name_f);
+		file_obj.mo_band = band;
 		if ( file_obj.is_open ){
 			file_obj.parse_out();
 			return file_obj.molecule;
@@ -93,6 +115,7 @@ Imolecule QMparser::get_molecule(){
 		}
 	}else if (program == "gaussian"){
 		gaussian_files file_obj(name_f);
+		file_obj.mo_band = band;
 		if ( file_obj.is_open ){
 			file_obj.parse_fchk();
 			file_obj.get_overlap_m();
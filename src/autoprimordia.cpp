@@ -23,6 +23,7 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <sstream>
 #include <omp.h>
 //=================================
 //PRIMoRDiA headers
@@ -42,6 +43,7 @@
 #include "../include/autoprimordia.h"
 #include "../include/scripts.h"
 #include "../include/ReactionAnalysis.h"
+#include "../include/output_writer.h"
 //===============================
 // std functions alias
 using std::move;
@@ -70,11 +72,22 @@ AutoPrimordia::AutoPrimordia(const char* file_list):
 				if	( list_f.lines[i].words[j] == "eband" ){
 					energy_crit = list_f.lines[i].get_int(j+1);
 				}
+				else if	( list_f.lines[i].words[j] == "aotol" ){
+					ao_tol = list_f.lines[i].get_double(j+1);
+				}
+				else if	( list_f.lines[i].words[j] == "lrds" ){
+					lrd_list = list_f.lines[i].words[j+1];
+				}
+				else if	( list_f.lines[i].words[j] == "pcut" ){
+					pair_cutoff = list_f.lines[i].get_double(j+1);
+				}
 				else if	( list_f.lines[i].words[j] == "dos" )		dos			= true;
 				else if	( list_f.lines[i].words[j] == "extrard" )	extra_RD	= true;
 				else if	( list_f.lines[i].words[j] == "Rscript" )	M_R			= true;
 				else if	( list_f.lines[i].words[j] == "composite" )	comp_H		= true;
 				else if	( list_f.lines[i].words[j] == "pymols" )	pymol_script= true;
+				else if	( list_f.lines[i].words[j] == "pvol" )		vol_out		= 1;
+				else if	( list_f.lines[i].words[j] == "pvol32" )	vol_out		= 2;
 			}
 		}
 	}
@@ -100,9 +113,9 @@ void AutoPrimordia::calculate_rd(){
 	//temporary variables
 	unsigned int i		= 0;
 	unsigned int mode	= 0;
-	const char* neut	= ".";
-	const char* cation	= ".";
-	const char* anion 	= ".";
+	string neut		= ".";
+	string cation	= ".";
+	string anion 	= ".";
 	string program		= ".";
 	string locHard 		= ".";
 	string btm			= "BD";
@@ -135,35 +148,35 @@ void AutoPrimordia::calculate_rd(){
 			primordia rd;			
 			switch ( mode ){
 				case 1:
-					neut	= list_f.lines[i].words[1].c_str();
+					neut	= list_f.lines[i].get_string(1);
 					locHard	= list_f.lines[i].words[2];
 					gridsize= list_f.lines[i].get_int(3);
 					program	= list_f.lines[i].words[4];
-					rd.init_FOA(neut,gridsize,locHard,mep,program,dens_tmp);
+					rd.init_FOA(neut.c_str(),gridsize,locHard,mep,program,dens_tmp);
 				break;
 				case 2:
-					neut	= list_f.lines[i].words[1].c_str();
-					cation	= list_f.lines[i].words[2].c_str();
-					anion	= list_f.lines[i].words[3].c_str();
+					neut	= list_f.lines[i].get_string(1);
+					cation	= list_f.lines[i].get_string(2);
+					anion	= list_f.lines[i].get_string(3);
 					locHard	= list_f.lines[i].words[4];
 					gridsize= list_f.lines[i].get_int(5);
 					charge	= list_f.lines[i].get_int(6);
 					program	= list_f.lines[i].words[7];
-					rd.init_FD(neut,cation,anion,gridsize,charge,mep,locHard,program,dens_tmp);
+					rd.init_FD(neut.c_str(),cation.c_str(),anion.c_str(),gridsize,charge,mep,locHard,program,dens_tmp);
 				break;
 				case 3:
-					neut	= list_f.lines[i].words[1].c_str();
+					neut	= list_f.lines[i].get_string(1);
 					locHard	= list_f.lines[i].words[2];
 					gridsize= list_f.lines[i].get_int(3);
 					bgap	= list_f.lines[i].get_int(4);
-					cation	= list_f.lines[i].words[5].c_str();
+					cation	= list_f.lines[i].get_string(5);
 					program = list_f.lines[i].words[6];
 					double r_atom[3];
 					r_atom[0] = list_f.lines[i].get_double(7);
 					r_atom[1] = list_f.lines[i].get_double(8);
 					r_atom[2] = list_f.lines[i].get_double(9);
 					int sze   = list_f.lines[i].get_int(10);
-					rd.init_protein_RD(neut,locHard,gridsize,bgap,r_atom,sze,cation,mep,btm,program);
+					rd.init_protein_RD(neut.c_str(),locHard,gridsize,bgap,r_atom,sze,cation.c_str(),mep,btm,program);
 				break;
 			}
 			RDs.emplace_back( move(rd) ); 
@@ -231,8 +244,8 @@ void AutoPrimordia::calculate_rd_from_traj(){
 			else{
 				m_log->inp_delim(1);
 				mode	= list_f.lines[i].get_int(0);
-				prefix	= remove_extension( list_f.lines[i].words[1].c_str() );
-				out_ext = get_file_ext( list_f.lines[i].words[1].c_str() );
+				prefix	= remove_extension( list_f.lines[i].get_string(1).c_str() );
+				out_ext = get_file_ext( list_f.lines[i].get_string(1).c_str() );
 				locHard	= list_f.lines[i].words[2];
 				gridsize= list_f.lines[i].get_int(3);
 				switch( mode ){
@@ -245,7 +258,7 @@ void AutoPrimordia::calculate_rd_from_traj(){
 					break;	
 					case 3:
 						bgap		= list_f.lines[i].get_int(4);
-						pdb_prefix	= remove_extension( list_f.lines[i].words[5].c_str() );
+						pdb_prefix	= remove_extension( list_f.lines[i].get_string(5).c_str() );
 						program 	= list_f.lines[i].words[6];
 						r_atom[0]	= list_f.lines[i].get_double(7);
 						r_atom[1]	= list_f.lines[i].get_double(8);
@@ -493,7 +506,7 @@ void AutoPrimordia::md_trajectory_analysis(){
 void AutoPrimordia::write_global(){
 
 	string fn = change_extension( m_file_list, ".global");
-	std::ofstream file_grd(fn.c_str());
+	std::ostringstream file_grd;
 	
 	file_grd << "GRD ";
 	for(unsigned j = 0; j<RDs[0].grd.grds.size(); j++ ){
@@ -510,7 +523,7 @@ void AutoPrimordia::write_global(){
 			}
 			file_grd << endl;
 	} 
-	file_grd.close();
+	out_writer.submit_text(file_grd.str(),fn);
 }
 /*************************************************************/
 AutoPrimordia::~AutoPrimordia(){
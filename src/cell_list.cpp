@@ -0,0 +1,411 @@
+// cell_list.cpp
+// source file for the cell_list class
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+//including c++ headers
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <omp.h>
+//including PRIMoRDiA headers
+#include "../include/common.h"
+#include "../include/Iatom.h"
+#include "../include/Imolecule.h"
+#include "../include/Icube.h"
+#include "../include/cell_list.h"
+
+using std::vector;
+
+// voxels in each direction of the blocks sharing one interaction list
+const unsigned int block_len = 8;
+
+/***********************************************************************/
+cell_list::cell_list()	:
+	theta(0.4)			,
+	side(0.0)			,
+	cutoff(0.0)			{
+
+	for( int i=0; i<3; i++ ) origin[i] = 0.0;
+}
+/***********************************************************************/
+cell_list::cell_list(const vector<double>& coords, const vector<double>& q)	:
+	theta(0.4)																,
+	side(0.0)																,
+	cutoff(0.0)																{
+
+	for( int i=0; i<3; i++ ) origin[i] = 0.0;
+	this->build(coords,q);
+}
+/***********************************************************************/
+cell_list::cell_list(const Imolecule& mol, const vector<double>& q)	:
+	theta(0.4)														,
+	side(0.0)														,
+	cutoff(0.0)														{
+
+	for( int i=0; i<3; i++ ) origin[i] = 0.0;
+	vector<double> coords(3*mol.atoms.size());
+	for( unsigned int i=0; i<mol.atoms.size(); i++ ){
+		coords[3*i]		= mol.atoms[i].xcoord;
+		coords[3*i+1]	= mol.atoms[i].ycoord;
+		coords[3*i+2]	= mol.atoms[i].zcoord;
+	}
+	this->build(coords,q);
+}
+/***********************************************************************/
+void cell_list::build(const vector<double>& coords, const vector<double>& q){
+	unsigned int n = q.size();
+	if ( n == 0 ) return;
+	double lo[3], hi[3];
+	for( int d=0; d<3; d++ ){ lo[d] = hi[d] = coords[d]; }
+	for( unsigned int i=1; i<n; i++ ){
+		for( int d=0; d<3; d++ ){
+			lo[d] = std::min(lo[d],coords[3*i+d]);
+			hi[d] = std::max(hi[d],coords[3*i+d]);
+		}
+	}
+	// leaf cells holding about eight charges, the padding keeps flat systems with finite cells
+	side = std::cbrt( (hi[0]-lo[0]+1.0)*(hi[1]-lo[1]+1.0)*(hi[2]-lo[2]+1.0)*8.0/n );
+	dims.clear();
+	dims.push_back( vector<unsigned int>(3) );
+	for( int d=0; d<3; d++ ){
+		origin[d]	= lo[d];
+		dims[0][d]	= (unsigned int)( (hi[d]-lo[d])/side ) + 1;
+	}
+	while( dims.back()[0] > 1 || dims.back()[1] > 1 || dims.back()[2] > 1 ){
+		vector<unsigned int> next(3);
+		for( int d=0; d<3; d++ ) next[d] = ( dims.back()[d] + 1 )/2;
+		dims.push_back(next);
+	}
+
+	//sorting the charges by leaf cell
+	unsigned int ncells = dims[0][0]*dims[0][1]*dims[0][2];
+	vector<unsigned int> leaf(n);
+	vector<unsigned int> cidx(3*n);
+	first.assign(ncells+1,0);
+	for( unsigned int i=0; i<n; i++ ){
+		for( int d=0; d<3; d++ ){
+			cidx[3*i+d] = std::min( (unsigned int)( (coords[3*i+d]-origin[d])/side ), dims[0][d]-1 );
+		}
+		leaf[i] = this->cell(0,cidx[3*i],cidx[3*i+1],cidx[3*i+2]);
+		first[leaf[i]+1]++;
+	}
+	for( unsigned int c=0; c<ncells; c++ ) first[c+1] += first[c];
+	vector<unsigned int> pos(first.begin(),first.end()-1);
+	xyz.resize(3*n);
+	charges.resize(n);
+	index.resize(n);
+	for( unsigned int i=0; i<n; i++ ){
+		unsigned int p	= pos[leaf[i]]++;
+		index[p]		= i;
+		charges[p]		= q[i];
+		for( int d=0; d<3; d++ ) xyz[3*p+d] = coords[3*i+d];
+	}
+
+	this->set_moments(q,levels);
+}
+/***********************************************************************/
+void cell_list::set_moments(const vector<double>& q, vector< vector<cell_moments> >& lvls) const {
+	unsigned int n = charges.size();
+	lvls.resize( dims.size() );
+	for( unsigned int l=0; l<dims.size(); l++ ){
+		double edge = side*( 1u << l );
+		lvls[l].assign( dims[l][0]*dims[l][1]*dims[l][2], cell_moments() );
+		for( unsigned int i=0; i<dims[l][0]; i++ ){
+			for( unsigned int j=0; j<dims[l][1]; j++ ){
+				for( unsigned int k=0; k<dims[l][2]; k++ ){
+					cell_moments& m = lvls[l][this->cell(l,i,j,k)];
+					m.center[0]	= origin[0] + (i+0.5)*edge;
+					m.center[1]	= origin[1] + (j+0.5)*edge;
+					m.center[2]	= origin[2] + (k+0.5)*edge;
+					m.radius	= 0.0;
+					m.q			= 0.0;
+					m.count		= 0;
+					for( int d=0; d<3; d++ ) m.dip[d] = 0.0;
+					for( int d=0; d<6; d++ ) m.quad[d] = 0.0;
+				}
+			}
+		}
+		for( unsigned int p=0; p<n; p++ ){
+			unsigned int c[3];
+			for( int d=0; d<3; d++ ) c[d] = std::min( (unsigned int)( (xyz[3*p+d]-origin[d])/side ), dims[0][d]-1 ) >> l;
+			cell_moments& m = lvls[l][ this->cell(l,c[0],c[1],c[2]) ];
+			double qp	= q[index[p]];
+			double rx	= xyz[3*p]		- m.center[0];
+			double ry	= xyz[3*p+1]	- m.center[1];
+			double rz	= xyz[3*p+2]	- m.center[2];
+			double r2	= rx*rx + ry*ry + rz*rz;
+			m.radius	= std::max(m.radius,std::sqrt(r2));
+			m.q			+= qp;
+			m.count++;
+			m.dip[0]	+= qp*rx;
+			m.dip[1]	+= qp*ry;
+			m.dip[2]	+= qp*rz;
+			m.quad[0]	+= qp*(3.0*rx*rx - r2);
+			m.quad[1]	+= qp*(3.0*ry*ry - r2);
+			m.quad[2]	+= qp*(3.0*rz*rz - r2);
+			m.quad[3]	+= qp*3.0*rx*ry;
+			m.quad[4]	+= qp*3.0*rx*rz;
+			m.quad[5]	+= qp*3.0*ry*rz;
+		}
+	}
+}
+/***********************************************************************/
+bool cell_list::same_coords(const Imolecule& mol) const {
+	if ( index.size() != mol.atoms.size() ) return false;
+	for( unsigned int p=0; p<index.size(); p++ ){
+		const Iatom& atom = mol.atoms[ index[p] ];
+		if ( xyz[3*p] != atom.xcoord || xyz[3*p+1] != atom.ycoord || xyz[3*p+2] != atom.zcoord ) return false;
+	}
+	return true;
+}
+/***********************************************************************/
+void cell_list::set_neighbours(double cut){
+	cutoff = cut;
+	near_first.clear();
+	near_index.clear();
+	near_inv.clear();
+	far_first.clear();
+	far_cells.clear();
+	if ( cutoff <= 0.0 || charges.empty() ) return;
+	unsigned int n		= charges.size();
+	unsigned int top	= dims.size() - 1;
+	vector< vector<unsigned int> > n_idx(n);
+	vector< vector<double> > n_inv(n);
+	vector< vector<unsigned int> > f_cells(n);
+	
+	omp_set_num_threads(NP);
+	#pragma omp parallel
+	{
+	vector<unsigned int> stack;
+	#pragma omp for schedule(dynamic,64)
+	for( unsigned int p=0; p<n; p++ ){
+		const double* a	= &xyz[3*p];
+		unsigned int i	= index[p];
+		stack.clear();
+		for( unsigned int c=0; c<levels[top].size(); c++ ){
+			stack.push_back(top);
+			stack.push_back(c);
+		}
+		while( !stack.empty() ){
+			unsigned int c = stack.back(); stack.pop_back();
+			unsigned int l = stack.back(); stack.pop_back();
+			const cell_moments& m = levels[l][c];
+			if ( m.count == 0 ) continue;
+			double rx	= a[0] - m.center[0];
+			double ry	= a[1] - m.center[1];
+			double rz	= a[2] - m.center[2];
+			double dist	= std::sqrt(rx*rx + ry*ry + rz*rz);
+			// only cells entirely beyond the cutoff are taken as multipoles
+			if ( dist - m.radius > cutoff && m.radius < theta*dist ){
+				f_cells[i].push_back(l);
+				f_cells[i].push_back(c);
+			}else if ( l == 0 ){
+				for( unsigned int o=first[c]; o<first[c+1]; o++ ){
+					if ( o == p ) continue;
+					double dx = a[0] - xyz[3*o];
+					double dy = a[1] - xyz[3*o+1];
+					double dz = a[2] - xyz[3*o+2];
+					n_idx[i].push_back(index[o]);
+					n_inv[i].push_back( 1.0/std::sqrt(dx*dx + dy*dy + dz*dz) );
+				}
+			}else{
+				unsigned int ci = c/(dims[l][1]*dims[l][2]);
+				unsigned int cj = (c/dims[l][2])%dims[l][1];
+				unsigned int ck = c%dims[l][2];
+				for( unsigned int x=2*ci; x<std::min(2*ci+2,dims[l-1][0]); x++ ){
+					for( unsigned int y=2*cj; y<std::min(2*cj+2,dims[l-1][1]); y++ ){
+						for( unsigned int z=2*ck; z<std::min(2*ck+2,dims[l-1][2]); z++ ){
+							stack.push_back(l-1);
+							stack.push_back( this->cell(l-1,x,y,z) );
+						}
+					}
+				}
+			}
+		}
+	}
+	}
+	
+	near_first.assign(n+1,0);
+	far_first.assign(n+1,0);
+	for( unsigned int i=0; i<n; i++ ){
+		near_first[i+1]	= near_first[i] + n_idx[i].size();
+		far_first[i+1]	= far_first[i] + f_cells[i].size()/2;
+		near_index.insert( near_index.end(), n_idx[i].begin(), n_idx[i].end() );
+		near_inv.insert( near_inv.end(), n_inv[i].begin(), n_inv[i].end() );
+		far_cells.insert( far_cells.end(), f_cells[i].begin(), f_cells[i].end() );
+		vector<unsigned int>().swap(n_idx[i]);
+		vector<double>().swap(n_inv[i]);
+		vector<unsigned int>().swap(f_cells[i]);
+	}
+}
+/***********************************************************************/
+vector<double> cell_list::charge_potential(const vector<double>& q) const {
+	unsigned int n = charges.size();
+	vector<double> v(n,0.0);
+	if ( n == 0 ) return v;
+	vector<double> pos(3*n);
+	for( unsigned int p=0; p<n; p++ ){
+		for( int d=0; d<3; d++ ) pos[3*index[p]+d] = xyz[3*p+d];
+	}
+	omp_set_num_threads(NP);
+	if ( near_first.empty() ){
+		#pragma omp parallel for schedule(dynamic,64)
+		for( unsigned int i=0; i<n; i++ ){
+			double value = 0.0;
+			for( unsigned int j=0; j<n; j++ ){
+				if ( i != j ){
+					double rx = pos[3*i]	- pos[3*j];
+					double ry = pos[3*i+1]	- pos[3*j+1];
+					double rz = pos[3*i+2]	- pos[3*j+2];
+					value += q[j]/std::sqrt(rx*rx + ry*ry + rz*rz);
+				}
+			}
+			v[i] = value;
+		}
+		return v;
+	}
+	vector< vector<cell_moments> > lvls;
+	this->set_moments(q,lvls);
+	#pragma omp parallel for schedule(dynamic,64)
+	for( unsigned int i=0; i<n; i++ ){
+		double value = 0.0;
+		for( unsigned int k=near_first[i]; k<near_first[i+1]; k++ ) value += q[near_index[k]]*near_inv[k];
+		for( unsigned int k=far_first[i]; k<far_first[i+1]; k++ ){
+			const cell_moments& m = lvls[ far_cells[2*k] ][ far_cells[2*k+1] ];
+			double rx	= pos[3*i]		- m.center[0];
+			double ry	= pos[3*i+1]	- m.center[1];
+			double rz	= pos[3*i+2]	- m.center[2];
+			double inv	= 1.0/std::sqrt(rx*rx + ry*ry + rz*rz);
+			double inv3	= inv*inv*inv;
+			double quad	= m.quad[0]*rx*rx + m.quad[1]*ry*ry + m.quad[2]*rz*rz + 2.0*( m.quad[3]*rx*ry + m.quad[4]*rx*rz + m.quad[5]*ry*rz );
+			value += m.q*inv + ( m.dip[0]*rx + m.dip[1]*ry + m.dip[2]*rz )*inv3 + 0.5*quad*inv3*inv*inv;
+		}
+		v[i] = value;
+	}
+	return v;
+}
+/***********************************************************************/
+unsigned int cell_list::cell(unsigned int lvl, unsigned int i, unsigned int j, unsigned int k) const {
+	return (i*dims[lvl][1] + j)*dims[lvl][2] + k;
+}
+/***********************************************************************/
+void cell_list::potential(Icube& out, double precision) const {
+	std::fill(out.scalar.begin(),out.scalar.end(),0.0);
+	if ( charges.empty() ) return;
+	unsigned int g[3] = { out.grid[0], out.grid[1], out.grid[2] };
+	unsigned int nb[3];
+	for( int d=0; d<3; d++ ) nb[d] = ( g[d] + block_len - 1 )/block_len;
+	unsigned int nblocks = nb[0]*nb[1]*nb[2];
+	unsigned int top = dims.size() - 1;
+
+	omp_set_num_threads(NP);
+	#pragma omp parallel
+	{
+	vector<double> near; // x, y, z and charge of the charges summed exactly.
+	vector<double> far; // center, charge, dipole and quadrupole of the cells taken as multipoles.
+	vector<unsigned int> stack;
+	#pragma omp for schedule(dynamic)
+	for( unsigned int b=0; b<nblocks; b++ ){
+		unsigned int start[3] = { (b/(nb[1]*nb[2]))*block_len, ((b/nb[2])%nb[1])*block_len, (b%nb[2])*block_len };
+		unsigned int end[3];
+		double lo[3], hi[3];
+		for( int d=0; d<3; d++ ){
+			end[d]	= std::min(start[d]+block_len,g[d]);
+			lo[d]	= out.origin[d] + start[d]*out.gridsides[d];
+			hi[d]	= out.origin[d] + (end[d]-1)*out.gridsides[d];
+		}
+		near.clear();
+		far.clear();
+		stack.clear();
+		for( unsigned int c=0; c<levels[top].size(); c++ ){
+			stack.push_back(top);
+			stack.push_back(c);
+		}
+		while( !stack.empty() ){
+			unsigned int c = stack.back(); stack.pop_back();
+			unsigned int l = stack.back(); stack.pop_back();
+			const cell_moments& m = levels[l][c];
+			if ( m.count == 0 ) continue;
+			double dist2 = 0.0;
+			for( int d=0; d<3; d++ ){
+				double dd = std::max( std::max(lo[d]-m.center[d],m.center[d]-hi[d]), 0.0 );
+				dist2 += dd*dd;
+			}
+			if ( m.radius*m.radius < theta*theta*dist2 ){
+				far.insert( far.end(), m.center, m.center+3 );
+				far.push_back(m.q);
+				far.insert( far.end(), m.dip, m.dip+3 );
+				far.insert( far.end(), m.quad, m.quad+6 );
+			}else if ( l == 0 ){
+				for( unsigned int p=first[c]; p<first[c+1]; p++ ){
+					near.insert( near.end(), &xyz[3*p], &xyz[3*p]+3 );
+					near.push_back(charges[p]);
+				}
+			}else{
+				unsigned int i = c/(dims[l][1]*dims[l][2]);
+				unsigned int j = (c/dims[l][2])%dims[l][1];
+				unsigned int k = c%dims[l][2];
+				for( unsigned int ci=2*i; ci<std::min(2*i+2,dims[l-1][0]); ci++ ){
+					for( unsigned int cj=2*j; cj<std::min(2*j+2,dims[l-1][1]); cj++ ){
+						for( unsigned int ck=2*k; ck<std::min(2*k+2,dims[l-1][2]); ck++ ){
+							stack.push_back(l-1);
+							stack.push_back( this->cell(l-1,ci,cj,ck) );
+						}
+					}
+				}
+			}
+		}
+
+		unsigned int nn = near.size()/4;
+		unsigned int nf = far.size()/13;
+		for( unsigned int x=start[0]; x<end[0]; x++ ){
+			double px = out.origin[0] + x*out.gridsides[0];
+			for( unsigned int y=start[1]; y<end[1]; y++ ){
+				double py = out.origin[1] + y*out.gridsides[1];
+				for( unsigned int z=start[2]; z<end[2]; z++ ){
+					double pz	= out.origin[2] + z*out.gridsides[2];
+					double v	= 0.0;
+					for( unsigned int i=0; i<nn; i++ ){
+						const double* a = &near[4*i];
+						double rx	= px - a[0];
+						double ry	= py - a[1];
+						double rz	= pz - a[2];
+						double r	= std::sqrt(rx*rx + ry*ry + rz*rz);
+						if ( precision > 0.0 )	v += a[3]/(r+precision);
+						else if ( r > 0.0 )		v += a[3]/r;
+					}
+					for( unsigned int i=0; i<nf; i++ ){
+						const double* a = &far[13*i];
+						double rx	= px - a[0];
+						double ry	= py - a[1];
+						double rz	= pz - a[2];
+						double inv	= 1.0/std::sqrt(rx*rx + ry*ry + rz*rz);
+						double inv3	= inv*inv*inv;
+						double quad	= a[7]*rx*rx + a[8]*ry*ry + a[9]*rz*rz + 2.0*( a[10]*rx*ry + a[11]*rx*rz + a[12]*ry*rz );
+						v += a[3]*inv + ( a[4]*rx + a[5]*ry + a[6]*rz )*inv3 + 0.5*quad*inv3*inv*inv;
+					}
+					out.scalar[(x*g[1]+y)*g[2]+z] = v;
+				}
+			}
+		}
+	}
+	}
+}
+/***********************************************************************/
+cell_list::~cell_list(){}
+//================================================================================
+//END OF FILE
+//================================================================================
@@ -21,6 +21,8 @@
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <charconv>
+#include <stdexcept>
 #include <sstream>
 #include <omp.h>
 #include <fstream>
@@ -35,6 +37,10 @@ bool dos			= false;
 bool extra_RD		= false;
 bool pymol_script	= false;
 double energy_crit	= 1;
+double ao_tol		= 1e-10;
+unsigned int vol_out= 0;
+string lrd_list		= "";
+double pair_cutoff	= 0.0;
 bool M_R			= false;
 bool comp_H			= false;
 /*********************************************************************************/
@@ -176,9 +182,16 @@ void rename_file(const char* file_name,std::string new_file_name){
 	fs::rename(f_name,nf_name);
 }
 /********************************************************************************/
-double D_E_conv(string sc_not){
-	std::replace(sc_not.begin(),sc_not.end(),'D','E');
-	double result = std::stod(sc_not);
+double D_E_conv(std::string_view sc_not){
+	char num[64];
+	std::size_t len = std::min( sc_not.size(), sizeof(num) );
+	std::replace_copy(sc_not.begin(),sc_not.begin()+len,num,'D','E');
+	const char* it = num;
+	if ( len > 0 && *it == '+' ) ++it;
+	double result = 0.0;
+	if ( std::from_chars(it,num+len,result).ec != std::errc() ){
+		throw std::invalid_argument("D_E_conv");
+	}
 	return result;
 }
 /********************************************************************************/
@@ -47,12 +47,14 @@ using std::cout;
 /**************************************************************/
 gamess_files::gamess_files()	:
 	is_open(false)				,
-	name_f("noname")			{
+	name_f("noname")			,
+	mo_band(-1)					{
 }
 /**************************************************************/
 gamess_files::gamess_files(const char* file_name):
 	is_open( false )							,
-	name_f(file_name)							{
+	name_f(file_name)							,
+	mo_band(-1)									{
 	
 	if ( IF_file( file_name ) ){
 		is_open = true;
@@ -134,7 +136,7 @@ void gamess_files::parse_log(){
 		else if ( Buffer.lines[i].IF_line("MULLIKEN",1,"LOWDIN",3,6) ) chg_in = i;
 		else if ( Buffer.lines[i].IF_line("BOND",0,"ANALYSIS",4,8) ) chg_fin = i;
 		else if ( Buffer.lines[i].IF_line("SOLVENT",4,"A.U.",7,8) ) {
-			molecule.energy_tot = stod(Buffer.lines[i].words[6]);
+			molecule.energy_tot = Buffer.lines[i].get_double(6);
 		}
 		else if ( Buffer.lines[i].IF_line("ONE",0,"ENERGY",2,5) ) {
 			molecule.energy_tot = Buffer.lines[i].get_double(4);
@@ -149,7 +151,7 @@ void gamess_files::parse_log(){
 	Ibuffer Buffer2(name_f,atom_in,atom_fin);
 	for( unsigned j=1;j<Buffer2.nLines;j++){
 		if ( Buffer2.lines[j].line_len == 5 ) {
-			string symb = Buffer2.lines[j].words[0];
+			string symb = Buffer2.lines[j].get_string(0);
 			double xcrd = Buffer2.lines[j].pop_double(2); 
 			double ycrd = Buffer2.lines[j].pop_double(2); 
 			double zcrd = Buffer2.lines[j].pop_double(2); 
@@ -176,7 +178,7 @@ void gamess_files::parse_log(){
 			if ( Buffer3.lines[i].line_len == 5 || Buffer3.lines[i].line_len == 6 ){
 				atom_n_basis.push_back(jj);
 				shell_n.push_back( Buffer3.lines[i].pop_int(0) );
-				shell_t.push_back( Buffer3.lines[i].words[0] );
+				shell_t.push_back( Buffer3.lines[i].get_string(0) );
 				exponents.push_back( Buffer3.lines[i].pop_double(2) );
 				if ( Buffer3.lines[i].line_len == 5 ) 	c_coefficients.push_back( Buffer3.lines[i].pop_double(2) );
 				else if ( Buffer3.lines[i].line_len == 6 ){
@@ -384,68 +386,93 @@ void gamess_files::parse_log(){
 	col_c			= 0;
 	line_indicator	= 0;
 	
-	molecule.coeff_MO.resize(aonum*aonum);
-	if ( molecule.betad ){ molecule.coeff_MO_beta.resize(aonum*aonum);}
+	// the atomic charges give the LUMO of the MO window, they are read before the MOs
+	int cnt_chg = 0;
+	
+	Ibuffer Buffer7(name_f,chg_in,chg_fin) ;
+	for(i=0;i<Buffer7.nLines;i++){
+		if ( Buffer7.lines[i].line_len == 6 )
+			molecule.atoms[cnt_chg++].charge = Buffer7.lines[i].get_double(3);
+	}
+	Buffer7.clear();
+	
+	// the energies of each block come before its coefficients, a first pass reads all of them to
+	// choose the MO columns to keep
+	unsigned nkeep = 0;
 	
 	Buffer4.clear();
 	Ibuffer Buffer5(name_f,fmo_in,fmo_fin);
-	for( unsigned j=1;j<Buffer5.nLines;j++){	
-		if ( Buffer5.lines[j].line_len > 0 && line_indicator == 0 ) {
-			col_n = Buffer5.lines[j].pop_int(0);
-			line_indicator++;
+	for( int pass=0; pass<2; pass++ ){
+		line_indicator = 0;
+		if ( pass == 1 ){
+			nkeep = molecule.MO_window(molecule.orb_energies,mo_band,27.2114);
+			molecule.coeff_MO.resize(aonum*nkeep);
 		}
-		else if ( Buffer5.lines[j].line_len > 0 && line_indicator == 1){
-			for( unsigned k=0; k<Buffer5.lines[j].line_len; k++){
-				molecule.orb_energies.push_back( Buffer5.lines[j].pop_double(0) );
-				molecule.MOnmb++;
+		for( unsigned j=1;j<Buffer5.nLines;j++){	
+			if ( Buffer5.lines[j].line_len > 0 && line_indicator == 0 ) {
+				col_n = Buffer5.lines[j].get_int(0);
+				line_indicator++;
 			}
-			line_indicator++;
-		}
-		else if ( Buffer5.lines[j].line_len > 0 && line_indicator == 2 )
-			line_indicator = 3;
-		else if ( Buffer5.lines[j].line_len >= 5 && line_indicator == 3 ){
-			row_n = Buffer5.lines[j].pop_int(0);			
-			for( l=0;l<Buffer5.lines[j].line_len-4;l++){ 
-				molecule.coeff_MO[(col_n+l-1)*aonum+row_n-1] = Buffer5.lines[j].pop_double(3);
+			else if ( Buffer5.lines[j].line_len > 0 && line_indicator == 1){
+				if ( pass == 0 ){
+					for( unsigned k=0; k<Buffer5.lines[j].line_len; k++){
+						molecule.orb_energies.push_back( Buffer5.lines[j].get_double(k) );
+						molecule.MOnmb++;
+					}
+				}
+				line_indicator++;
+			}
+			else if ( Buffer5.lines[j].line_len > 0 && line_indicator == 2 )
+				line_indicator = 3;
+			else if ( Buffer5.lines[j].line_len >= 5 && line_indicator == 3 ){
+				row_n = Buffer5.lines[j].get_int(0);
+				if ( pass == 1 ){
+					for( l=0;l<Buffer5.lines[j].line_len-4 && col_n+l<=nkeep;l++){ 
+						molecule.coeff_MO[(col_n+l-1)*aonum+row_n-1] = Buffer5.lines[j].get_double(l+4);
+					}
+				}
+				if ( row_n == aonum ) line_indicator = 0;
 			}
-			if ( row_n == aonum ) line_indicator = 0;
 		}
 	}
 	
 	Buffer5.clear();
 	if ( fmob_in > 0 ){
 		Ibuffer Buffer6(name_f,fmob_in,fmob_fin);
-		for( unsigned j=4;j<Buffer6.nLines;j++){	
-			if ( Buffer6.lines[j].line_len > 0 && line_indicator == 0 ) {
-				col_n = Buffer6.lines[j].pop_int(0);
-				line_indicator++;
+		for( int pass=0; pass<2; pass++ ){
+			line_indicator = 0;
+			if ( pass == 1 ){
+				nkeep = molecule.MO_window(molecule.orb_energies_beta,mo_band,27.2114);
+				molecule.coeff_MO_beta.resize(aonum*nkeep);
 			}
-			else if ( Buffer6.lines[j].line_len > 0 && line_indicator == 1 ){
-				for( k=0;k<Buffer6.lines[j].line_len;k++){
-					molecule.orb_energies_beta.push_back( Buffer6.lines[j].pop_double(0) );
-					molecule.MOnmb_beta++;
+			for( unsigned j=4;j<Buffer6.nLines;j++){	
+				if ( Buffer6.lines[j].line_len > 0 && line_indicator == 0 ) {
+					col_n = Buffer6.lines[j].get_int(0);
+					line_indicator++;
 				}
-				line_indicator++;
-			}
-			else if ( Buffer6.lines[j].line_len >  0 && line_indicator == 2 ) line_indicator = 3;
-			else if ( Buffer6.lines[j].line_len >= 5 && line_indicator == 3 ){
-				row_n = Buffer6.lines[j].pop_int(0);
-				for(l=0;l<Buffer6.lines[j].line_len-4;l++){
-					molecule.coeff_MO_beta[(col_n+l-1)*aonum+row_n-1] = Buffer6.lines[j].pop_double(3);
+				else if ( Buffer6.lines[j].line_len > 0 && line_indicator == 1 ){
+					if ( pass == 0 ){
+						for( k=0;k<Buffer6.lines[j].line_len;k++){
+							molecule.orb_energies_beta.push_back( Buffer6.lines[j].get_double(k) );
+							molecule.MOnmb_beta++;
+						}
+					}
+					line_indicator++;
+				}
+				else if ( Buffer6.lines[j].line_len >  0 && line_indicator == 2 ) line_indicator = 3;
+				else if ( Buffer6.lines[j].line_len >= 5 && line_indicator == 3 ){
+					row_n = Buffer6.lines[j].get_int(0);
+					if ( pass == 1 ){
+						for(l=0;l<Buffer6.lines[j].line_len-4 && col_n+l<=nkeep;l++){
+							molecule.coeff_MO_beta[(col_n+l-1)*aonum+row_n-1] = Buffer6.lines[j].get_double(l+4);
+						}
+					}
+					if ( row_n == aonum ) line_indicator = 0;
 				}
-				if ( row_n == aonum ) line_indicator = 0;
 			}
 		}
 		Buffer6.clear();
 	}
-	int cnt_chg = 0;
-	
-	Ibuffer Buffer7(name_f,chg_in,chg_fin) ;
-	for(i=0;i<Buffer7.nLines;i++){
-		if ( Buffer7.lines[i].line_len == 6 )
-			molecule.atoms[cnt_chg++].charge = Buffer7.lines[i].get_double(3);
-	}
-	
 	molecule.energy_tot	= molecule.energy_tot*27.2114;
 	molecule.homo_energy= molecule.homo_energy*27.2114; // conversion to electronvolt
 	molecule.lumo_energy	= molecule.lumo_energy*27.2114;
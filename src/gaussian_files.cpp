@@ -46,12 +46,14 @@ using std::unique_ptr;
 //================================================
 gaussian_files::gaussian_files():
 	name_f("noname")			,
-	is_open(false)				{
+	is_open(false)				,
+	mo_band(-1)					{
 }
 /**********************************************************************/
 gaussian_files::gaussian_files(const char* file_name):
 	name_f(file_name)								,
-	is_open(false)									{
+	is_open(false)									,
+	mo_band(-1)										{
 	
 	if ( IF_file(file_name) ) {
 		is_open = true;
@@ -101,6 +103,10 @@ void gaussian_files::parse_fchk(){
 	unsigned chgs_f		= 0;
 	unsigned dens_i		= 0;
 	unsigned dens_f		= 0;
+	unsigned alpha_c_n	= 0;
+	unsigned beta_c_n	= 0;
+	unsigned alpha_keep	= 0;
+	unsigned beta_keep	= 0;
 	
 	vector<double>	coords;
 	vector<int>		shell_t;
@@ -139,8 +145,12 @@ void gaussian_files::parse_fchk(){
 		else if ( Buffer.lines[i].IF_line("Alpha",0,"coefficients",2,6) ){
 			if ( beta_e_i > 0 ) beta_e_f  = alpha_c_i = i;
 			else alpha_e_f = alpha_c_i = i;
+			alpha_c_n = Buffer.lines[i].get_int(5);
+		}
+		else if ( Buffer.lines[i].IF_line("Beta",0,"coefficients",2,6) ){
+			beta_c_i  = alpha_c_f = i;
+			beta_c_n  = Buffer.lines[i].get_int(5);
 		}
-		else if ( Buffer.lines[i].IF_line("Beta",0,"coefficients",2,6) ){  beta_c_i  = alpha_c_f = i; }
 		else if ( Buffer.lines[i].IF_line("Total",0,"Density",2,6) ){
 			dens_i = i;
 			if ( beta_c_i > 0 )	beta_c_f = i;
@@ -209,12 +219,27 @@ void gaussian_files::parse_fchk(){
 			}
 		}
 		else if( i>alpha_c_i && i<alpha_c_f ){
-			for(j=0;j<Buffer.lines[i].line_len;j++){
+			// the energies are already stored, only the MO columns of the window are kept
+			if ( i == alpha_c_i+1 ){
+				// the Mulliken charges come after the coefficients, the window needs them for the LUMO
+				for( unsigned l=chgs_i+1, n=0; chgs_i>0 && l<chgs_f && l<Buffer.lines.size(); l++ ){
+					for( j=0; j<Buffer.lines[l].line_len && n<molecule.atoms.size(); j++ ){
+						molecule.atoms[n++].charge = Buffer.lines[l].get_double(j);
+					}
+				}
+				alpha_keep = alpha_c_n;
+				if ( molecule.MOnmb > 0 ) alpha_keep = ( alpha_c_n/molecule.MOnmb )*molecule.MO_window(molecule.orb_energies,mo_band,27.2114);
+			}
+			for(j=0;j<Buffer.lines[i].line_len && molecule.coeff_MO.size()<alpha_keep;j++){
 				molecule.coeff_MO.push_back(Buffer.lines[i].pop_double(0));
 			}
 		}
 		else if( i>beta_c_i && i<beta_c_f ){
-			for(j=0;j<Buffer.lines[i].line_len;j++){
+			if ( i == beta_c_i+1 ){
+				beta_keep = beta_c_n;
+				if ( molecule.MOnmb_beta > 0 ) beta_keep = ( beta_c_n/molecule.MOnmb_beta )*molecule.MO_window(molecule.orb_energies_beta,mo_band,27.2114);
+			}
+			for(j=0;j<Buffer.lines[i].line_len && molecule.coeff_MO_beta.size()<beta_keep;j++){
 				molecule.coeff_MO_beta.push_back(Buffer.lines[i].pop_double(0));
 			}
 		}
@@ -402,10 +427,10 @@ void gaussian_files::get_overlap_m(){
 		int col_c = 0;
 	
 		for(int i=over_in+1;i<over_fin;i++){
-			if ( Buffer.lines[i].words.size() == 1 ) col_n = stoi(Buffer.lines[i].words[0]);
-			else if( Buffer.lines[i].words.size() > 1 && Buffer.lines[i].words[1].size() < 6) col_n = stoi(Buffer.lines[i].words[0]);
+			if ( Buffer.lines[i].words.size() == 1 ) col_n = Buffer.lines[i].get_int(0);
+			else if( Buffer.lines[i].words.size() > 1 && Buffer.lines[i].words[1].size() < 6) col_n = Buffer.lines[i].get_int(0);
 			else{
-				row_n = stoi(Buffer.lines[i].words[0]) -1;
+				row_n = Buffer.lines[i].get_int(0) -1;
 				col_c = col_n -1;
 				for(int j=1;j<Buffer.lines[i].line_len;j++){
 					molecule.m_overlap[col_c + (row_n*(row_n+1))/2] = Buffer.lines[i].pop_double_f(1);
@@ -21,6 +21,7 @@
 #include <string>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 #include <omp.h>
 //---------------------------------------------
 //including PRIMoRDiA headers 
@@ -30,6 +31,9 @@
 #include "../include/Iatom.h"
 #include "../include/Imolecule.h"
 #include "../include/Icube.h"
+#include "../include/orb_kernels.h"
+#include "../include/volume_file.h"
+#include "../include/cell_list.h"
 #include "../include/gridgen.h" 
 //-----------------------------------------------
 using std::unique_ptr;
@@ -37,6 +41,8 @@ using std::move;
 using std::string;
 using std::cout;
 using std::endl;
+
+const unsigned int block_len = 8; // voxels per side of the screening blocks
 /***********************************************************************/
 gridgen::gridgen()	:
 	name("nonamed")	,
@@ -89,12 +95,13 @@ gridgen::gridgen(int grd					,
 	if ( orbs.size() <= molecule.num_of_atoms ){
 		m_log->input_message("Your atomic basis may not be loaded properly.\nVerify your QM data and/or use -log option to run PRIMoRDiA\n.");
 	}
-	psi.resize(grid_len[0]);
-	for ( j=0; j<grid_len[0]; j++){
-		psi[j].resize(grid_len[1]);
-		for( k =0; k<grid_len[1]; k++) psi[j][k].resize(grid_len[2]);
+	m_log->input_message( string("Atomic orbital grid kernels using instruction set: ") + orb_kernels_isa() + "\n" );
+	if ( orb_kernels_error() > 1.0e-13 ){
+		m_log->write_warning("The exponential of the atomic orbital grid kernels is not accurate in this build, verify the floating point flags of orb_kernels.cpp!");
 	}
+	this->calc_ao_extents();
 	
+	// the generation kernels write directly in the scalar buffer of the cube
 	density.voxelN = grd*grd*grd;
 	density.scalar.resize(density.voxelN);
 	for ( i=0; i<3; i++){
@@ -102,9 +109,16 @@ gridgen::gridgen(int grd					,
 		density.gridsides[i]= grid_sides[i];
 		density.grid[i]		= grid_len[i];
 	}
-	density.molecule.atoms			= molecule.atoms;
-	density.molecule.num_of_atoms	= molecule.num_of_atoms;
-	density.molecule,name			= molecule.name;
+	// geometry handle shared by all the cubes generated from this grid, without the basis set
+	Imolecule geometry;
+	geometry.name			= molecule.name;
+	geometry.atoms			= molecule.atoms;
+	geometry.num_of_atoms	= molecule.num_of_atoms;
+	for ( j=0; j<geometry.atoms.size(); j++ ){
+		geometry.atoms[j].orbitals.clear();
+		geometry.atoms[j].norb = 0;
+	}
+	density.molecule		= std::make_shared<const Imolecule>( move(geometry) );
 }
 /***********************************************************************/
 void gridgen::set_lim(double* Min, double* gridSides, int *gridSize){
@@ -114,11 +128,6 @@ void gridgen::set_lim(double* Min, double* gridSides, int *gridSize){
 		grid_len[i]		= gridSize[i];
 		top_corner[i]	= grid_sides[i]*grid_len[i] + origin[i];
 	}
-	psi.resize(grid_len[0]);
-	for (unsigned int j=0;j<grid_len[0];j++){
-		psi[j].resize(grid_len[1]);
-		for(unsigned int k=0;k<grid_len[1];k++) psi[j][k].resize(grid_len[2]);
-	}
 	density.voxelN = grid_len[0]*grid_len[1]*grid_len[2];
 	density.scalar.resize(density.voxelN);
 	for (int i=0;i<3;i++){
@@ -215,29 +224,31 @@ double gridgen::calc_gauss_orb(int i, int x, int y, int z){
 	return value;
 }
 /***********************************************************************/
+double gridgen::calc_sphe_angular(int i, double xi, double yi, double zi){
+	switch ( orbs[i].ang ){
+		case ang_d0:	return 3*zi*zi - ( xi*xi + yi*yi + zi*zi );
+		case ang_d1p:	return xi*zi;
+		case ang_d1n:	return yi*zi;
+		case ang_d2p:	return xi*xi - yi*yi;
+		case ang_d2n:	return xi*yi;
+		case ang_f0:	return -3*xi*xi*zi - 3*yi*yi*zi + 2*zi*zi*zi;
+		case ang_f1p:	return -xi*xi*xi - yi*yi*xi  + 4*zi*zi*xi;
+		case ang_f1n:	return -xi*xi*yi - yi*yi*yi + 4*zi*zi*yi;
+		case ang_f2p:	return -yi*yi*zi + xi*xi*zi;
+		case ang_f2n:	return xi*yi*zi;
+		case ang_f3p:	return -xi*xi*xi + 3*yi*yi*xi;
+		case ang_f3n:	return -3*xi*xi*yi + yi*yi*yi;
+		default:		return pow(xi,orbs[i].powx)*pow(yi,orbs[i].powy)*pow(zi,orbs[i].powz);
+	}
+}
+/***********************************************************************/
 double gridgen::calc_orca_sphe(int i, int x, int y, int z){
 	double value = 0.0;
 	double xi	= x*grid_sides[0] + origin[0] - AOxcoords[i];
 	double yi	= y*grid_sides[1] + origin[1] - AOycoords[i];
 	double zi	= z*grid_sides[2] + origin[2] - AOzcoords[i];
 	double r	= xi*xi + yi*yi + zi*zi; 
-	double dg	= 0;
-	double xx	= pow(xi,orbs[i].powx);
-	double yy	= pow(yi,orbs[i].powy);
-	double zz	= pow(zi,orbs[i].powz);
-	dg =  xx*yy*zz;
-	if		( orbs[i].symmetry == "D0"	)	dg = 3*zi*zi - r;
-	else if	( orbs[i].symmetry == "D1p"	)	dg = xi*zi;
-	else if	( orbs[i].symmetry == "D1n"	)	dg = yi*zi;
-	else if	( orbs[i].symmetry == "D2p"	)	dg = xi*xi - yi*yi;
-	else if	( orbs[i].symmetry == "D2n"	)	dg = xi*yi;
-	else if	( orbs[i].symmetry == "f0"	)	dg = -3*xi*xi*zi - 3*yi*yi*zi + 2*zi*zi*zi;
-	else if	( orbs[i].symmetry == "f1p"	)	dg = -xi*xi*xi - yi*yi*xi  + 4*zi*zi*xi;
-	else if	( orbs[i].symmetry == "f1n"	)	dg = -xi*xi*yi - yi*yi*yi + 4*zi*zi*yi;
-	else if	( orbs[i].symmetry == "f2p"	)	dg = -yi*yi*zi + xi*xi*zi;
-	else if	( orbs[i].symmetry == "f2n"	)	dg = xi*yi*zi;
-	else if	( orbs[i].symmetry == "f3p" )	dg = -xi*xi*x + 3*yi*yi*xi;
-	else if	( orbs[i].symmetry == "f3n"	)	{ dg = -3*xi*xi*yi + yi*yi*yi; }
+	double dg	= this->calc_sphe_angular(i,xi,yi,zi);
 	for(unsigned int k=0;k<orbs[i].gtos.size();k++){
 		double dr	= r*orbs[i].gtos[k].exponent;
 		dr			= exp(-dr);
@@ -251,148 +262,301 @@ double gridgen::calc_aorb(int i, int x, int y, int z){
 	else  return this->calc_slater_orb(i,x,y,z);
 }
 /***********************************************************************/
-double gridgen::calc_orb_voxel(int nmo,int x,int y,int z,bool beta){
-	double orb_value= 0.0;
-	unsigned int aos= orbs.size();
-	if ( !beta ){
-		for(unsigned int i=0;i<aos;i++){
-			if ( molecule.coeff_MO[aos*nmo + i] > 1e-8 ) {
-				orb_value += calc_aorb(i,x,y,z)*molecule.coeff_MO[aos*nmo + i];
-			}
+void gridgen::calc_ao_extents(){
+	AOextent.resize( orbs.size() );
+	for( unsigned int i=0; i<orbs.size(); i++ ){
+		// bound of the angular part relative to r^l
+		double l		= orbs[i].powx + orbs[i].powy + orbs[i].powz;
+		double ang_max	= 1.0;
+		if ( orbs[i].spherical ){
+			if		( orbs[i].ang >= ang_d0 && orbs[i].ang <= ang_d2n ) { l = 2; ang_max = 2.0; }
+			else if ( orbs[i].ang >= ang_f0 && orbs[i].ang <= ang_f3n ) { l = 3; ang_max = 4.0; }
 		}
-	}else if ( beta ){
-		for(unsigned int i=0;i<orbs.size();i++){
-			if ( molecule.coeff_MO_beta[molecule.MOnmb_beta*nmo + i] > 1e-8 ) {
-				orb_value += calc_aorb(i,x,y,z)*molecule.coeff_MO_beta[aos*nmo + i];
+		double coef		= 0.0;
+		double expo		= orbs[i].alpha;
+		double r_peak	= 0.0;
+		double r_max	= 1000.0;
+		if ( orbs[i].gto ){
+			// the most diffuse primitive dominates the tail
+			expo = orbs[i].gtos[0].exponent;
+			for( unsigned int k=0; k<orbs[i].gtos.size(); k++ ){
+				coef += std::abs(orbs[i].gtos[k].n_fact);
+				if ( orbs[i].gtos[k].exponent < expo ) expo = orbs[i].gtos[k].exponent;
+			}
+			coef	*= ang_max;
+			r_peak	= sqrt( l/(2*expo) );
+		}else{
+			coef	= std::abs(orbs[i].n_factor);
+			l		= orbs[i].shell - 1.0;
+			if ( expo > 0.0 ){
+				r_peak	= l/expo;
+				r_max	= 40.0/expo;
 			}
 		}
+		double r		= r_peak;
+		double value	= 0.0;
+		do{
+			r += 0.1;
+			if ( orbs[i].gto )	value = coef*pow(r,l)*exp(-expo*r*r);
+			else				value = coef*pow(r,l)*exp(-expo*r);
+		}while( value > ao_tol && r < r_max );
+		AOextent[i] = r;
 	}
-	return orb_value;
 }
 /***********************************************************************/
-double gridgen::calc_orb_voxel_orca(int nm,int x,int y,int z,bool beta){
-	double orb_value = 0.0;
-	unsigned int aos = orbs.size();
-	if ( !beta ){
-		for(unsigned int i=0;i<aos;i++){
-			if ( molecule.coeff_MO[aos*nm + i] > 1e-8 ) {
-				orb_value +=calc_orca_sphe (i,x,y,z)*molecule.coeff_MO[aos*nm + i];
-			}
-		}
-	}else if ( beta ){
-		for(unsigned int i=0;i<orbs.size();i++){
-			if ( molecule.coeff_MO_beta[molecule.MOnmb_beta*nm + i] > 1e-8 ) {
-				orb_value += calc_orca_sphe(i,x,y,z)*molecule.coeff_MO_beta[aos*nm + i];
-			}
-		}
+void gridgen::screen_block(unsigned int bx, unsigned int by, unsigned int bz, std::vector<unsigned int>& aos){
+	unsigned int b[3]	= { bx, by, bz };
+	double lo[3];
+	double hi[3];
+	for( int d=0; d<3; d++ ){
+		unsigned int first	= b[d]*block_len;
+		unsigned int last	= std::min(first+block_len,grid_len[d]) - 1;
+		lo[d]	= first*grid_sides[d] + origin[d];
+		hi[d]	= last*grid_sides[d]  + origin[d];
+	}
+	aos.clear();
+	for( unsigned int i=0; i<orbs.size(); i++ ){
+		// distance from the orbital center to the block bounding box
+		double dx = std::max( std::max(lo[0]-AOxcoords[i],AOxcoords[i]-hi[0]), 0.0 );
+		double dy = std::max( std::max(lo[1]-AOycoords[i],AOycoords[i]-hi[1]), 0.0 );
+		double dz = std::max( std::max(lo[2]-AOzcoords[i],AOzcoords[i]-hi[2]), 0.0 );
+		if ( dx*dx + dy*dy + dz*dz < AOextent[i]*AOextent[i] ) aos.push_back(i);
+	}
+}
+/***********************************************************************/
+void gridgen::restrict_aos(const std::vector<char>& used, std::vector<unsigned int>& aos){
+	if ( used.size() == 0 ) return;
+	unsigned int n = 0;
+	for( unsigned int a=0; a<aos.size(); a++ ){
+		if ( used[aos[a]] ) aos[n++] = aos[a];
 	}
-	return orb_value;
+	aos.resize(n);
 }
 /***********************************************************************/
 void gridgen::calculate_orb(int Nmo, bool beta){
 	orbital = true;
 	Norb    = Nmo;
-	unsigned int x,y,z;
-	omp_set_num_threads(NP);
-	#pragma omp parallel for collapse(3) default(shared) private(x,y,z) 
-	for (x=0;x<grid_len[0];x++){
-		for (y=0;y<grid_len[1];y++){
-			for (z=0;z<grid_len[2];z++) {
-				psi[x][y][z] = calc_orb_voxel(Nmo,x,y,z,beta);
-			}
-		}
-	}
-	density.add_data(psi);
+	std::vector<int> mos(1,Nmo);
+	std::vector<Icube> orb = this->calculate_orbs(mos,beta);
+	density.scalar = move(orb[0].scalar);
 	density.name = name;
 }
 /***********************************************************************/
 void gridgen::calculate_orb_orca(int Nmo, bool beta){
-	orbital = true;
-	Norb    = Nmo;
-	unsigned int x,y,z;
-	omp_set_num_threads(NP);
-	#pragma omp parallel for collapse(3) default(shared) private(x,y,z) 
-	for (x=0;x<grid_len[0];x++){
-		for (y=0;y<grid_len[1];y++){
-			for (z=0;z<grid_len[2];z++) {
-				psi[x][y][z] = calc_orb_voxel_orca(Nmo,x,y,z,beta);
-			}
-		}
-	}
-	density.add_data(psi);
-	density.name = name;
+	// the spherical orbitals are dispatched in calc_ao_block
+	this->calculate_orb(Nmo,beta);
 }
-
 /***********************************************************************/
-double gridgen::electron_density_mo(int x, int y, int z){
-	double valuealfa	= 0.0;
-	double valuebeta	= 0.0;
-	double phiK			= 0.0;
-	std::vector<double> phialpha;
-	std::vector<double> phibeta;
-	unsigned int i,j,k,l,m,MOn,MOnb,AOn;
-	MOn		= molecule.MOnmb;
-	MOnb	= molecule.MOnmb_beta;
-	phialpha.resize(MOn);
-	phibeta.resize(MOnb);
-	AOn		= orbs.size();
-
-	for (i=0;i<AOn;i++){
-		phiK = calc_aorb(i,x,y,z);
-		for (j=0;j<MOn;j++){
-			if( molecule.occupied[j] > 1e-08 ) {
-				phialpha[j] += molecule.coeff_MO[AOn*j+i]*phiK;
+void gridgen::calc_ao_block(unsigned int bx					,
+							unsigned int by					,
+							unsigned int bz					,
+							const std::vector<unsigned int>& aos,
+							Eigen::MatrixXd& phi)			{
+	unsigned int x0 = bx*block_len;
+	unsigned int y0 = by*block_len;
+	unsigned int z0 = bz*block_len;
+	unsigned int nx = std::min( x0+block_len, grid_len[0] ) - x0;
+	unsigned int ny = std::min( y0+block_len, grid_len[1] ) - y0;
+	unsigned int nz = std::min( z0+block_len, grid_len[2] ) - z0;
+	bool sphe = orbs[0].spherical;
+	phi.resize(nx*ny*nz,aos.size());
+	// per axis tables of the block: coordinates, cartesian powers and gaussian factors
+	std::vector<double> dx(nx), dy(ny), dz(nz);
+	std::vector<double> px(nx), py(ny), pz(nz);
+	std::vector<double> ex(nx), ey(ny), ez(nz);
+	std::vector<double> radial(nx*ny*nz);
+	// one column per atomic orbital, voxels ordered as in the cube scalar
+	for (unsigned int a=0;a<aos.size();a++){
+		unsigned int i = aos[a];
+		unsigned int v = 0;
+		for (unsigned int x=0;x<nx;x++){
+			dx[x] = (x0+x)*grid_sides[0] + origin[0] - AOxcoords[i];
+			px[x] = 1.0;
+			for (unsigned int p=0;p<orbs[i].powx;p++) px[x] *= dx[x];
+		}
+		for (unsigned int y=0;y<ny;y++){
+			dy[y] = (y0+y)*grid_sides[1] + origin[1] - AOycoords[i];
+			py[y] = 1.0;
+			for (unsigned int p=0;p<orbs[i].powy;p++) py[y] *= dy[y];
+		}
+		for (unsigned int z=0;z<nz;z++){
+			dz[z] = (z0+z)*grid_sides[2] + origin[2] - AOzcoords[i];
+			pz[z] = 1.0;
+			for (unsigned int p=0;p<orbs[i].powz;p++) pz[z] *= dz[z];
+		}
+		if ( !orbs[i].gto ){
+			int nr = int(orbs[i].shell) - 1 - int(orbs[i].powx + orbs[i].powy + orbs[i].powz);
+			if ( nr < 0 ){
+				for (unsigned int x=x0;x<x0+nx;x++){
+					for (unsigned int y=y0;y<y0+ny;y++){
+						for (unsigned int z=z0;z<z0+nz;z++) phi(v++,a) = calc_slater_orb(i,x,y,z);
+					}
+				}
+				continue;
+			}
+			// radial part along the z lines, in place in the orbital column
+			for (unsigned int x=0;x<nx;x++){
+				for (unsigned int y=0;y<ny;y++){
+					slater_line(nz,dx[x]*dx[x]+dy[y]*dy[y],dz.data(),orbs[i].alpha,nr,&phi(v,a));
+					double pxy = orbs[i].n_factor*px[x]*py[y];
+					for (unsigned int z=0;z<nz;z++,v++) phi(v,a) *= pxy*pz[z];
+				}
 			}
+			continue;
 		}
-		for (k=0;k<MOnb;k++){
-			if( molecule.occupied[k] > 1e-08 ) {
-				phibeta[k] += molecule.coeff_MO_beta[AOn*k+i]*phiK;
+		// exp(-a*r^2) = exp(-a*x^2)*exp(-a*y^2)*exp(-a*z^2)
+		std::fill(radial.begin(),radial.end(),0.0);
+		for (unsigned int k=0;k<orbs[i].gtos.size();k++){
+			double expo = orbs[i].gtos[k].exponent;
+			gauss_line(nx,dx.data(),expo,orbs[i].gtos[k].n_fact,ex.data());
+			gauss_line(ny,dy.data(),expo,1.0,ey.data());
+			gauss_line(nz,dz.data(),expo,1.0,ez.data());
+			v = 0;
+			for (unsigned int x=0;x<nx;x++){
+				for (unsigned int y=0;y<ny;y++){
+					double exy = ex[x]*ey[y];
+					for (unsigned int z=0;z<nz;z++) radial[v++] += exy*ez[z];
+				}
+			}
+		}
+		// the angular type is resolved once per orbital, cartesian factors come from the tables
+		v = 0;
+		if ( sphe && orbs[i].ang >= ang_d0 && orbs[i].ang <= ang_f3n ){
+			for (unsigned int x=0;x<nx;x++){
+				for (unsigned int y=0;y<ny;y++){
+					for (unsigned int z=0;z<nz;z++,v++) phi(v,a) = radial[v]*calc_sphe_angular(i,dx[x],dy[y],dz[z]);
+				}
+			}
+		}else{
+			for (unsigned int x=0;x<nx;x++){
+				for (unsigned int y=0;y<ny;y++){
+					double pxy = px[x]*py[y];
+					for (unsigned int z=0;z<nz;z++,v++) phi(v,a) = radial[v]*pxy*pz[z];
+				}
 			}
 		}
 	}
-	for (l=0;l<MOn;l++){
-		valuealfa += molecule.occupied[l]*phialpha[l]*phialpha[l];
-	}
-	for (m=0;m<MOnb;m++){
-		valuebeta += molecule.occupied_beta[m]*phibeta[m]*phibeta[m];
+}
+/***********************************************************************/
+std::vector<char> gridgen::mo_support(const std::vector<int>& mos, bool beta){
+	// atomic orbitals with a stored coefficient in any of the localized MOs, empty for dense MOs
+	std::vector<char> used;
+	if ( beta || !molecule.sparse_MO() ) return used;
+	used.assign(orbs.size(),0);
+	for (unsigned int m=0;m<mos.size();m++){
+		for (unsigned int k=molecule.lmo_first[mos[m]];k<molecule.lmo_first[mos[m]+1];k++) used[molecule.lmo_ao[k]] = 1;
 	}
-	return valuealfa + valuebeta;
+	return used;
 }
 /***********************************************************************/
-double gridgen::electron_density_mo_orca(int x, int y, int z){
-	double valuealfa	= 0.0;
-	double valuebeta	= 0.0;
-	double phiK			= 0.0;
-	std::vector<double> phialpha;
-	std::vector<double> phibeta;
-	unsigned int i,j,k,l,m,MOn,MOnb,AOn;
-	MOn		= molecule.MOnmb;
-	MOnb	= molecule.MOnmb_beta;
-	phialpha.resize(MOn);
-	phibeta.resize(molecule.MOnmb_beta);
-
-	AOn		= orbs.size();
-
-	for (i=0;i<AOn;i++){
-		phiK = calc_orca_sphe(i,x,y,z);
-		for (j=0;j<MOn;j++){
-			if( molecule.occupied[j] > 1e-08 ) {
-				phialpha[j] += molecule.coeff_MO[AOn*j+i]*phiK;
-			}
+void gridgen::block_coeff(const std::vector<unsigned int>& aos, const std::vector<int>& mos, bool beta, Eigen::MatrixXd& cmo){
+	unsigned int ao = orbs.size();
+	cmo.resize( aos.size(), mos.size() );
+	if ( beta || !molecule.sparse_MO() ){
+		const std::vector<double>& coeff = beta ? molecule.coeff_MO_beta : molecule.coeff_MO;
+		for (unsigned int m=0;m<mos.size();m++){
+			for (unsigned int a=0;a<aos.size();a++) cmo(a,m) = coeff[ao*mos[m] + aos[a]];
+		}
+		return;
+	}
+	// both the block orbitals and the stored coefficients are in ascending order
+	cmo.setZero();
+	for (unsigned int m=0;m<mos.size();m++){
+		unsigned int a = 0;
+		for (unsigned int k=molecule.lmo_first[mos[m]];k<molecule.lmo_first[mos[m]+1];k++){
+			while ( a < aos.size() && aos[a] < molecule.lmo_ao[k] ) a++;
+			if ( a == aos.size() ) break;
+			if ( aos[a] == molecule.lmo_ao[k] ) cmo(a,m) = molecule.lmo_coeff[k];
 		}
-		for (k=0;k<MOnb;k++){
-			if( molecule.occupied[k] > 1e-08 ) {
-				phibeta[k] += molecule.coeff_MO_beta[AOn*k+i]*phiK;
+	}
+}
+/***********************************************************************/
+std::vector<Icube> gridgen::calculate_orbs(const std::vector<int>& mos, bool beta){
+	std::vector<Icube> orbs_grid( mos.size(), density );
+	if ( mos.size() == 0 ) return orbs_grid;
+	std::vector<char> used = this->mo_support(mos,beta);
+	unsigned int nb[3];
+	for( int d=0; d<3; d++ ) nb[d] = ( grid_len[d] + block_len - 1 )/block_len;
+	unsigned int bx,by,bz;
+	omp_set_num_threads(NP);
+	#pragma omp parallel for collapse(3) default(shared) private(bx,by,bz) schedule(dynamic)
+	for (bx=0;bx<nb[0];bx++){
+		for (by=0;by<nb[1];by++){
+			for (bz=0;bz<nb[2];bz++){
+				std::vector<unsigned int> aos;
+				this->screen_block(bx,by,bz,aos);
+				this->restrict_aos(used,aos);
+				Eigen::MatrixXd phi;
+				this->calc_ao_block(bx,by,bz,aos,phi);
+				Eigen::MatrixXd cmo;
+				this->block_coeff(aos,mos,beta,cmo);
+				// all the requested orbitals of the block in a single product
+				Eigen::MatrixXd mo_block = phi*cmo;
+				unsigned int xf = std::min( (bx+1)*block_len, grid_len[0] );
+				unsigned int yf = std::min( (by+1)*block_len, grid_len[1] );
+				unsigned int zf = std::min( (bz+1)*block_len, grid_len[2] );
+				for (unsigned int m=0;m<mos.size();m++){
+					unsigned int v = 0;
+					for (unsigned int x=bx*block_len;x<xf;x++){
+						for (unsigned int y=by*block_len;y<yf;y++){
+							for (unsigned int z=bz*block_len;z<zf;z++) {
+								orbs_grid[m].scalar[(x*grid_len[1]+y)*grid_len[2]+z] = mo_block(v++,m);
+							}
+						}
+					}
+				}
 			}
 		}
 	}
-	for (l=0;l<MOn;l++){
-		valuealfa += molecule.occupied[l]*phialpha[l]*phialpha[l];
+	for (unsigned int m=0;m<mos.size();m++){
+		orbs_grid[m].name = name + "_" + std::to_string(mos[m]);
 	}
-	for (m=0;m<MOnb;m++){
-		valuebeta += molecule.occupied_beta[m]*phibeta[m]*phibeta[m];
+	return orbs_grid;
+}
+/***********************************************************************/
+Icube gridgen::calc_band(const std::vector<int>& mos, const std::vector<double>& weights, bool square){
+	Icube band(density);
+	std::fill(band.scalar.begin(),band.scalar.end(),0.0);
+	band.name = name;
+	if ( mos.size() == 0 ) return band;
+	std::vector<char> used = this->mo_support(mos,false);
+	Eigen::VectorXd w( mos.size() );
+	for (unsigned int m=0;m<mos.size();m++) w(m) = weights[m];
+	unsigned int nb[3];
+	for( int d=0; d<3; d++ ) nb[d] = ( grid_len[d] + block_len - 1 )/block_len;
+	unsigned int bx,by,bz;
+	omp_set_num_threads(NP);
+	#pragma omp parallel for collapse(3) default(shared) private(bx,by,bz) schedule(dynamic)
+	for (bx=0;bx<nb[0];bx++){
+		for (by=0;by<nb[1];by++){
+			for (bz=0;bz<nb[2];bz++){
+				std::vector<unsigned int> aos;
+				this->screen_block(bx,by,bz,aos);
+				this->restrict_aos(used,aos);
+				Eigen::MatrixXd phi;
+				this->calc_ao_block(bx,by,bz,aos,phi);
+				Eigen::MatrixXd cmo;
+				this->block_coeff(aos,mos,false,cmo);
+				// the orbitals of the window are reduced in the block, no grid is stored per orbital
+				Eigen::MatrixXd mo_block = phi*cmo;
+				Eigen::VectorXd acc;
+				if ( square )	acc = mo_block.cwiseAbs2()*w;
+				else			acc = mo_block*w;
+				unsigned int xf = std::min( (bx+1)*block_len, grid_len[0] );
+				unsigned int yf = std::min( (by+1)*block_len, grid_len[1] );
+				unsigned int zf = std::min( (bz+1)*block_len, grid_len[2] );
+				unsigned int v	= 0;
+				for (unsigned int x=bx*block_len;x<xf;x++){
+					for (unsigned int y=by*block_len;y<yf;y++){
+						for (unsigned int z=bz*block_len;z<zf;z++) {
+							band.scalar[(x*grid_len[1]+y)*grid_len[2]+z] = acc(v++);
+						}
+					}
+				}
+			}
+		}
 	}
-	return valuealfa + valuebeta;
+	return band;
 }
 /***********************************************************************/
 double gridgen::electron_density(int x,int y, int z){
@@ -422,40 +586,104 @@ double gridgen::electron_density(int x,int y, int z){
 	return value;
 }
 /***********************************************************************/
-void gridgen::calculate_density(){
-	unsigned int x,y,z;
-	omp_set_num_threads(NP);
-	//chronometer.reset();
-	#pragma omp parallel for collapse (3) default(shared) private(x,y,z) 
-	for (unsigned int x=0;x<grid_len[0];x++){
-		for (unsigned int y=0;y<grid_len[1];y++){
-			for (unsigned int z=0;z<grid_len[2];z++){
-				psi[x][y][z] = electron_density_mo(x,y,z);
+void gridgen::calc_density_matrix(Eigen::MatrixXd& P){
+	unsigned int ao = orbs.size();
+	P = Eigen::MatrixXd::Zero(ao,ao);
+	Eigen::setNbThreads(NP);
+	for( int s=0; s<2; s++ ){
+		const std::vector<double>& coeff	= s == 0 ? molecule.coeff_MO	: molecule.coeff_MO_beta;
+		const std::vector<int>& occ			= s == 0 ? molecule.occupied	: molecule.occupied_beta;
+		unsigned int nmo					= s == 0 ? molecule.MOnmb		: molecule.MOnmb_beta;
+		std::vector<unsigned int> occ_mos;
+		for( unsigned int i=0; i<nmo && i<occ.size(); i++ ){
+			if ( occ[i] > 0 ) occ_mos.push_back(i);
+		}
+		if ( occ_mos.size() == 0 ) continue;
+		if ( s == 0 && molecule.sparse_MO() ){
+			// outer products of the stored coefficients of each localized MO
+			for( unsigned int m=0; m<occ_mos.size(); m++ ){
+				double w		= double(occ[occ_mos[m]]);
+				unsigned int k0	= molecule.lmo_first[occ_mos[m]];
+				unsigned int k1	= molecule.lmo_first[occ_mos[m]+1];
+				for( unsigned int k=k0; k<k1; k++ ){
+					double wc = w*molecule.lmo_coeff[k];
+					for( unsigned int l=k0; l<k1; l++ ) P(molecule.lmo_ao[k],molecule.lmo_ao[l]) += wc*molecule.lmo_coeff[l];
+				}
 			}
+			continue;
 		}
-	} 
-	//cout << "Execution time: " << chronometer.return_wall_time() << " seconds" << endl;
-	density.add_data(psi);
-	density.name = name;
+		// occupied coefficients scaled by the square root of the occupation
+		Eigen::MatrixXd c_occ( ao, occ_mos.size() );
+		for( unsigned int m=0; m<occ_mos.size(); m++ ){
+			double w = sqrt( double(occ[occ_mos[m]]) );
+			for( unsigned int mu=0; mu<ao; mu++ ) c_occ(mu,m) = coeff[ao*occ_mos[m]+mu]*w;
+		}
+		P.noalias() += c_occ*c_occ.transpose();
+	}
 }
 /***********************************************************************/
-void gridgen::calculate_density_orca(){
-	unsigned int x,y,z;
+void gridgen::calculate_density(){
+	Eigen::MatrixXd P;
+	this->calc_density_matrix(P);
+	unsigned int nb[3];
+	for( int d=0; d<3; d++ ) nb[d] = ( grid_len[d] + block_len - 1 )/block_len;
+	unsigned int bx,by,bz;
 	omp_set_num_threads(NP);
-	//chronometer.reset();
-	#pragma omp parallel for collapse (3) default(shared) private(x,y,z) 
-	for (unsigned int x=0;x<grid_len[0];x++){
-		for (unsigned int y=0;y<grid_len[1];y++){
-			for (unsigned int z=0;z<grid_len[2];z++){
-				psi[x][y][z] = electron_density_mo_orca(x,y,z);
+	#pragma omp parallel for collapse(3) default(shared) private(bx,by,bz) schedule(dynamic)
+	for (bx=0;bx<nb[0];bx++){
+		for (by=0;by<nb[1];by++){
+			for (bz=0;bz<nb[2];bz++){
+				std::vector<unsigned int> aos;
+				this->screen_block(bx,by,bz,aos);
+				Eigen::MatrixXd phi;
+				this->calc_ao_block(bx,by,bz,aos,phi);
+				// pair bound |P_mn|*max|phi_m|*max|phi_n| over the block
+				unsigned int n = aos.size();
+				std::vector<double> phi_max(n,0.0);
+				for (unsigned int a=0;a<n;a++) phi_max[a] = phi.col(a).cwiseAbs().maxCoeff();
+				std::vector<unsigned int> act;
+				for (unsigned int a=0;a<n;a++){
+					for (unsigned int b=0;b<n;b++){
+						if ( std::abs( P(aos[a],aos[b]) )*phi_max[a]*phi_max[b] > ao_tol ) {
+							act.push_back(a);
+							break;
+						}
+					}
+				}
+				Eigen::MatrixXd phi_act( phi.rows(), act.size() );
+				Eigen::MatrixXd p_act( act.size(), act.size() );
+				for (unsigned int a=0;a<act.size();a++){
+					phi_act.col(a) = phi.col(act[a]);
+					for (unsigned int b=0;b<act.size();b++){
+						double p = P(aos[act[a]],aos[act[b]]);
+						if ( std::abs(p)*phi_max[act[a]]*phi_max[act[b]] > ao_tol ) p_act(a,b) = p;
+						else p_act(a,b) = 0.0;
+					}
+				}
+				Eigen::VectorXd rho = (phi_act*p_act).cwiseProduct(phi_act).rowwise().sum();
+				unsigned int xf = std::min( (bx+1)*block_len, grid_len[0] );
+				unsigned int yf = std::min( (by+1)*block_len, grid_len[1] );
+				unsigned int zf = std::min( (bz+1)*block_len, grid_len[2] );
+				unsigned int v	= 0;
+				for (unsigned int x=bx*block_len;x<xf;x++){
+					for (unsigned int y=by*block_len;y<yf;y++){
+						for (unsigned int z=bz*block_len;z<zf;z++) {
+							if ( act.size() > 0 ) density.scalar[(x*grid_len[1]+y)*grid_len[2]+z] = rho(v++);
+							else density.scalar[(x*grid_len[1]+y)*grid_len[2]+z] = 0.0;
+						}
+					}
+				}
 			}
 		}
-	} 
-	//cout << "Execution time: " << chronometer.return_wall_time() << " seconds" << endl;
-	density.add_data(psi);
+	}
 	density.name = name;
 }
 /***********************************************************************/
+void gridgen::calculate_density_orca(){
+	// the spherical orbitals are dispatched in calc_ao_block
+	this->calculate_density();
+}
+/***********************************************************************/
 Icube& gridgen::get_cube(){ return density; }
 /***********************************************************************/
 Icube& gridgen::calc_HOMO(){
@@ -486,13 +714,20 @@ Icube& gridgen::calc_LUMO_density(){
 /***********************************************************************/
 void gridgen::write_grid(){
 	string cb_name;
-	string cb_name2;
-	if ( orbital ) {
+	if ( vol_out > 0 ){
+		if ( orbital ) {
+			std::string nmo = std::to_string(Norb);
+			volume_writer volume(molecule.name + "_MO_" + nmo + ".pvol",density,vol_out == 2,true);
+			volume.add_field( density, "MO_" + nmo );
+		}else{
+			volume_writer volume(molecule.name + ".pvol",density,vol_out == 2,true);
+			volume.add_field(density,"density");
+		}
+	}
+	else if ( orbital ) {
 		std::string nmo = std::to_string(Norb);
-		cb_name  = molecule.name + "_ph1_" + nmo + ".cube";
-		cb_name2 = molecule.name + "_ph2_" + nmo + ".cube";
+		cb_name  = molecule.name + "_MO_" + nmo + ".cube";
 		density.write_cube(cb_name);
-		density.write_cube(cb_name2);
 	}else{
 		cb_name =  molecule.name + ".cube"; 
 		density.write_cube(cb_name);
@@ -501,114 +736,77 @@ void gridgen::write_grid(){
 /***********************************************************************/
 Icube gridgen::calc_HOMO_band(int bandn){
 	Icube temp(density);
+	std::vector<int> mos;
 	for ( int i=(molecule.homoN-bandn);i<=molecule.homoN;i++){
-		if ( molecule.orb_energies[i] >= (molecule.homo_energy-energy_crit) ){
-			this->calculate_orb(i,false);
-			temp = temp + density;
-		}
+		if ( molecule.orb_energies[i] >= (molecule.homo_energy-energy_crit) ) mos.push_back(i);
 	}
+	std::vector<double> weights(mos.size(),1.0);
+	temp = temp + this->calc_band(mos,weights,false);
 	return temp;
 }
 /***********************************************************************/
 Icube gridgen::calc_LUMO_band(int bandn){
 	Icube temp(density);
+	std::vector<int> mos;
 	for ( int i=molecule.lumoN;i<=molecule.lumoN+bandn;i++){
-		if ( molecule.orb_energies[i] <= (molecule.lumo_energy+energy_crit) ){
-			this->calculate_orb(i,false);
-			temp = temp + density;
-		}
+		if ( molecule.orb_energies[i] <= (molecule.lumo_energy+energy_crit) ) mos.push_back(i);
 	}
+	std::vector<double> weights(mos.size(),1.0);
+	temp = temp + this->calc_band(mos,weights,false);
 	return temp;
 }
 /***********************************************************************/
 Icube gridgen::calc_band_EAS(int bandn){
-	Icube temp = density;
-	temp = temp*0.0;
-	int cnt = 0;
+	std::vector<int> mos;
 	for ( int i=(molecule.homoN-bandn+1);i<=molecule.homoN;i++){
-		if ( molecule.orb_energies[i] >= (molecule.homo_energy-energy_crit) ){
-			this->calculate_orb(i,false);
-			temp = temp + density.SQ();
-			cnt++;
-		}
+		if ( molecule.orb_energies[i] >= (molecule.homo_energy-energy_crit) ) mos.push_back(i);
 	}
-	temp = temp/cnt;
-	//cout << "used " << cnt << " MO" << endl;
-	return temp;
+	// average of the squared orbitals
+	std::vector<double> weights(mos.size(),1.0/mos.size());
+	//cout << "used " << mos.size() << " MO" << endl;
+	return this->calc_band(mos,weights,true);
 }
 /***********************************************************************/
 Icube gridgen::calc_band_NAS(int bandn){
-	Icube temp(density);
-	temp = temp*0.0;
-	int cnt = 0;
+	std::vector<int> mos;
 	for ( int i=molecule.lumoN;i<molecule.lumoN+bandn;i++){
-		if ( molecule.orb_energies[i] <= (molecule.lumo_energy+energy_crit) ){
-			this->calculate_orb(i,false);
-			temp = temp + density.SQ();
-			cnt++;
-		}
+		if ( molecule.orb_energies[i] <= (molecule.lumo_energy+energy_crit) ) mos.push_back(i);
 	}
-	temp = temp/cnt;
-	return temp;
+	std::vector<double> weights(mos.size(),1.0/mos.size());
+	return this->calc_band(mos,weights,true);
 }
 /***********************************************************************/
 Icube gridgen::calc_EBLC_EAS(){
-	Icube temp = density;
-	double coefficient = 0.0;
-	temp 	= temp*0.0;
+	std::vector<int> mos;
+	std::vector<double> coefficients;
 	for ( int i=0;i<=molecule.homoN;i++){
-		coefficient = exp(-abs(molecule.orb_energies[i]-molecule.homo_energy ) );
+		double coefficient = exp(-abs(molecule.orb_energies[i]-molecule.homo_energy ) );
 		if ( coefficient > 0.36 ){
-			this->calculate_orb(i,false);
-			temp = temp + density.SQ()*coefficient;
+			mos.push_back(i);
+			coefficients.push_back(coefficient);
 		}
 	}
-	return temp;
+	return this->calc_band(mos,coefficients,true);
 } 
 /***********************************************************************/
 Icube gridgen::calc_EBLC_NAS( ){
-	Icube temp = density;
-	double coefficient = 0.0;
-	temp = temp*0.0;
-	for ( int i=molecule.lumoN;i<=molecule.orb_energies.size();i++){
-		coefficient = exp(-abs(molecule.orb_energies[i]-molecule.lumo_energy ) );
+	std::vector<int> mos;
+	std::vector<double> coefficients;
+	for ( int i=molecule.lumoN;i<molecule.orb_energies.size();i++){
+		double coefficient = exp(-abs(molecule.orb_energies[i]-molecule.lumo_energy ) );
 		if ( coefficient > 0.36 ){
-			this->calculate_orb(i,false);
-			temp = temp + density.SQ()*coefficient;
-			//cnt++;
+			mos.push_back(i);
+			coefficients.push_back(coefficient);
 		}
 	}
-	return temp;
+	return this->calc_band(mos,coefficients,true);
 } 
 /***********************************************************************/
 Icube& gridgen::grid_from_atoms(std::vector<double> values){
-	unsigned int x,y,z,i;
-	double xi,yi,zi,xj,yj,zj,r,invR,v = 0.0;
-	double precision 				= 1e-13;
-	
+	double precision = 1e-13;
 	if ( values.size() == molecule.num_of_atoms ){
-		omp_set_num_threads(NP);
-		#pragma omp parallel for collapse(3) shared(precision) private(xi,yi,zi,xj,yj,zj,r,invR,x,y,z,i) reduction(+:v)
-		for ( x=0;x<grid_len[0];x++ ){
-			for ( y=0;y<grid_len[1];y++ ){
-				for ( z=0;z<grid_len[2];z++ ){
-					xi	=	x*grid_sides[0] + origin[0];
-					yi	=	y*grid_sides[1] + origin[1];
-					zi	=	z*grid_sides[2] + origin[2];
-					for ( i=0;i<molecule.atoms.size();i++ ){
-						xj	=	xi -molecule.atoms[i].xcoord;
-						yj	=	yi -molecule.atoms[i].ycoord;
-						zj	=	zi -molecule.atoms[i].zcoord;
-						r	=	sqrt(xj*xj +  yj*yj + zj*zj);
-						invR	= 1/(r+precision);
-						v	+= invR*values[i];
-					}
-					psi[x][y][z] = v;
-					v= 0;
-				}
-			}
-		} 
-		density.add_data(psi);
+		cell_list atoms(molecule,values);
+		atoms.potential(density,precision);
 		density.name = name;
 	}
 	return density;
@@ -30,6 +30,8 @@
 #include "../include/Imolecule.h"
 #include "../include/QMparser.h"
 #include "../include/Icube.h"
+#include "../include/volume_file.h"
+#include "../include/output_writer.h"
 #include "../include/Ibuffer.h"
 #include "../include/Iline.h"
 #include "../include/gridgen.h"
@@ -76,6 +78,11 @@ interface::interface(int argc, char** argv) :
 	for(int i=0;i<m_argc;i++){
 		if      ( m_argv[i] == "-np")		NP			= stoi(m_argv[i+1]);
 		else if ( m_argv[i] == "-verbose")	M_verbose 	= true;
+		else if ( m_argv[i] == "-aotol")	ao_tol		= stod(m_argv[i+1]);
+		else if ( m_argv[i] == "-pvol")		vol_out		= 1;
+		else if ( m_argv[i] == "-pvol32")	vol_out		= 2;
+		else if ( m_argv[i] == "-lrds")		lrd_list	= m_argv[i+1];
+		else if ( m_argv[i] == "-pcut")		pair_cutoff	= stod(m_argv[i+1]);
 	}
 	
 	//----------------------------------
@@ -113,15 +120,15 @@ void interface::run(){
 	else if ( runtyp == "-cubed"){
 		const char* file_name1 = m_argv[2].c_str();
 		const char* file_name2 = m_argv[3].c_str();
-		Icube cub1(file_name1);
-		Icube cub2(file_name2);
+		Icube cub1 = load_cube(file_name1);
+		Icube cub2 = load_cube(file_name2);
 		double diff = cub1.diff_integral(cub2);
 		cout << "Absolute difference: "<< diff << endl;
 		double similarity = cub1.similarity_index(cub2,"default");
 		cout << "Similarity index: " << similarity << endl;
 	}
 	else if ( runtyp == "-int"){
-		Icube cube(m_argv[2].c_str());
+		Icube cube = load_cube(m_argv[2]);
 		cout << cube.calc_cube_integral() << endl;
 	}	
 	else if ( runtyp == "-p_traj" ){
@@ -164,7 +171,7 @@ void interface::MO_cube(){
 void interface::ED_cube(){
 	m_log->input_message("You are using PRIMoRDiA for generation of total electron density scalar field cube file!\n");
 	
-	unique_ptr<QMparser> qmfile ( new QMparser( m_argv[2].c_str(),m_argv[4] ) );
+	unique_ptr<QMparser> qmfile ( new QMparser( m_argv[2].c_str(),m_argv[4],0 ) );
 	Imolecule molecule ( move(qmfile->get_molecule() ) );
 	qmfile.reset(nullptr);
 	
@@ -178,7 +185,7 @@ void interface::ED_cube(){
 }
 /***********************************************************************/
 void interface::Comp_cube(){		
-	unique_ptr<QMparser> qmfile ( new QMparser ( m_argv[2].c_str(),m_argv[4]) );
+	unique_ptr<QMparser> qmfile ( new QMparser ( m_argv[2].c_str(),m_argv[4],0) );
 	Imolecule molecule ( move(qmfile->get_molecule() ) );
 	qmfile.reset(nullptr);
 	unique_ptr<gridgen> dens ( new gridgen( stoi(m_argv[3].c_str() ),move(molecule) ) );
@@ -203,11 +210,17 @@ void interface::write_help(){
 				<< "-input: Produce input from the name list in the current folder\n"
 				<< "-cp   : Electron density complement\n"
 				<< "-cubed: cube file differences and similarity index calculation\n"
+				<< "        fields of volume files are given as file.pvol:field_name\n"
 				<< "-cdiff: Calculates the similarity index from a list of cube files\n"
 				<< "-int  : Calculates the integral of the cube file\n"
 				<< "Generic options is the options must be placed after all the other arguments\n"
 				<< "Generic options:\n"
 				<< "-np [n] : program runs using n threads\n"
+				<< "-aotol [v]: atomic orbital values below v are neglected in the grid calculations ( default 1e-10 )\n"
+				<< "-pvol   : grids are written in one compressed binary volume file ( .pvol ) instead of cube files\n"
+				<< "-pvol32 : same as -pvol storing the values in single precision\n"
+				<< "-lrds [n1,n2,...]: only these volumetric descriptors and their prerequisites are calculated and written\n"
+				<< "-pcut [r]: condensed atom pair potentials are exact within r angstroms and use multipoles beyond ( default 0, all pairs exact )\n"
 				<< "-log    : program produces a log file of its operations\n"
 				<< "-verbose: program prints to the console messages about its operations\n"
 				<< endl;
@@ -350,7 +363,8 @@ void interface::print_options(){
 }
 /***********************************************************************/
 interface::~interface(){
-	
+	// the output files still queued are written before the program ends
+	out_writer.finish();
 }
 //////////////////////////////////////////////////
 //================================================================================
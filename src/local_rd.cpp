@@ -25,6 +25,7 @@
 #include <omp.h>
 #include <algorithm>
 #include <vector>
+#include <sstream>
 // include statements from PRIMORDiA-libs
 #include "../include/common.h"
 #include "../include/Iatom.h"
@@ -32,6 +33,10 @@
 #include "../include/Icube.h"
 #include "../include/global_rd.h"
 #include "../include/local_rd.h"
+#include "../include/poisson_fft.h"
+#include "../include/cell_list.h"
+#include "../include/volume_file.h"
+#include "../include/output_writer.h"
 
 using std::cout;
 using std::endl;
@@ -65,6 +70,32 @@ std::vector<std::string> descriptor_names = {
 	"L_Hardness_TFD"			// 21 if TFD
 };
 
+// descriptors each one is calculated from, the basic fields 0-6 come from the constructors
+std::vector< std::vector<unsigned int> > descriptor_deps = {
+	{},			// 0  HOMO
+	{},			// 1  LUMO
+	{},			// 2  Elec_Dens
+	{},			// 3  ED_cation
+	{},			// 4  ED_anion
+	{},			// 5  Nucleophilicity
+	{},			// 6  Electrophilicity
+	{5,6},		// 7  Radical_sucseptibility
+	{5,6},		// 8  Netphilicity
+	{2,5},		// 9  L_Hardness_LCP
+	{2},		// 10 L_Hardness_Vee
+	{5},		// 11 Fukui_Potential_left
+	{6},		// 12 Fukui_Potential_right
+	{7},		// 13 Fukui_Potential_avg
+	{5,6},		// 14 L_Hardness_INT
+	{8},		// 15 Softness_Dual
+	{7},		// 16 Softness_AVG
+	{8},		// 17 Hyper_Softess
+	{8},		// 18 Multiphilicity
+	{2},		// 19 MEP
+	{},			// 20 MO_BAND
+	{2,10}		// 21 L_Hardness_TFD
+};
+
 
 //==========================================================================
 //Class member functions definitions
@@ -74,11 +105,13 @@ local_rd::local_rd()			:
 	FD(false)					,
 	LH(false)					,
 	band(false)					,
-	charge(1)					,
 	TFD(false)					,
+	charge(1)					,
 	rd_names(descriptor_names)	{
 		
 	lrds.resize( rd_names.size() );
+	requested.assign( rd_names.size(), false );
+	needed.assign( rd_names.size(), false );
 }
 /***********************************************************************************/
 local_rd::local_rd(Icube HOmo		,
@@ -87,18 +120,15 @@ local_rd::local_rd(Icube HOmo		,
 	FD(false)								,
 	LH(false)								,
 	band(false)								,
-	charge(1)								,
 	TFD(false)								,
+	charge(1)								,
 	rd_names(descriptor_names)				{
 	
 	lrds.resize( rd_names.size() );
 	
-	lrds[0] = HOmo;
-	lrds[1] = LUmo;
-	lrds[5] = lrds[0]*lrds[0];
-	lrds[6] = lrds[1]*lrds[1];
-	lrds[7] = (lrds[5]+lrds[6])/2.0;
-	lrds[8] = lrds[6]-lrds[5];
+	lrds[0] = move(HOmo);
+	lrds[1] = move(LUmo);
+	this->set_requests();
 }
 /***********************************************************************************/
 local_rd::local_rd(Icube elec_dens	,
@@ -108,19 +138,16 @@ local_rd::local_rd(Icube elec_dens	,
 	FD(false)								,
 	LH(true)								,
 	band(false)								,
-	charge(1)								,
 	TFD(false)								,
+	charge(1)								,
 	rd_names(descriptor_names)				{
 	
 	lrds.resize( rd_names.size() );
 
-	lrds[0] = HOmo;
-	lrds[1] = LUmo;
-	lrds[2] = elec_dens;
-	lrds[5] = lrds[0]*lrds[0];
-	lrds[6] = lrds[1]*lrds[1];
-	lrds[7] = (lrds[5]+lrds[6])/2.0;
-	lrds[8] = lrds[6]-lrds[5];
+	lrds[0] = move(HOmo);
+	lrds[1] = move(LUmo);
+	lrds[2] = move(elec_dens);
+	this->set_requests();
 	
 }
 /***********************************************************************************/
@@ -131,20 +158,17 @@ local_rd::local_rd(Icube elecDens			,
 	name(elecDens.name)						,
 	FD(true)								,
 	LH(true)								,
-	charge(chg)								,
-	TFD(false)								,
 	band(false)								,
+	TFD(false)								,
+	charge(chg)								,
 	rd_names(descriptor_names)				{
 	
 	lrds.resize( rd_names.size() );
 
-	lrds[2] = elecDens;
-	lrds[3] = cationDens;
-	lrds[4] = anionDens;
-	lrds[5] = lrds[2] - lrds[3];
-	lrds[6] = lrds[4] - lrds[2];
-	lrds[7] = (lrds[5]+lrds[6])/2.0;
-	lrds[8] = lrds[6]-lrds[5];	
+	lrds[2] = move(elecDens);
+	lrds[3] = move(cationDens);
+	lrds[4] = move(anionDens);
+	this->set_requests();
 
 }
 /***********************************************************************************/
@@ -152,21 +176,27 @@ local_rd::local_rd(const local_rd& lrd_rhs)	:
 	name(lrd_rhs.name)						,
 	FD(lrd_rhs.FD)							,
 	LH(lrd_rhs.LH)							,
-	charge(lrd_rhs.charge)					,
+	band(lrd_rhs.band)						,
 	TFD(lrd_rhs.TFD)						,
+	charge(lrd_rhs.charge)					,
+	lrds(lrd_rhs.lrds)						,
 	rd_names(lrd_rhs.rd_names)				,
-	lrds(lrd_rhs.lrds)						{
+	requested(lrd_rhs.requested)			,
+	needed(lrd_rhs.needed)					{
 }
 /***********************************************************************************/
 local_rd& local_rd::operator=(const local_rd& lrd_rhs){
 	if( this!=&lrd_rhs ){
 		name			= lrd_rhs.name;
 		FD				= lrd_rhs.FD;
-		charge			= lrd_rhs.charge;
 		LH				= lrd_rhs.LH;
+		band			= lrd_rhs.band;
 		TFD				= lrd_rhs.TFD;
-		rd_names		= lrd_rhs.rd_names;
+		charge			= lrd_rhs.charge;
 		lrds			= lrd_rhs.lrds;
+		rd_names		= lrd_rhs.rd_names;
+		requested		= lrd_rhs.requested;
+		needed			= lrd_rhs.needed;
 	}
 	return *this;
 }
@@ -175,121 +205,145 @@ local_rd::local_rd(local_rd&& lrd_rhs) noexcept	:
 	name(lrd_rhs.name)							,
 	FD(lrd_rhs.FD)								,
 	LH(lrd_rhs.LH)								,
-	charge(lrd_rhs.charge)						,
+	band(lrd_rhs.band)							,
 	TFD(lrd_rhs.TFD)							,
+	charge(lrd_rhs.charge)						,
+	lrds( move(lrd_rhs.lrds) )					,
 	rd_names( move(lrd_rhs.rd_names) )			,
-	lrds( move(lrd_rhs.lrds) )					{
+	requested( move(lrd_rhs.requested) )		,
+	needed( move(lrd_rhs.needed) )				{
 }
 /***********************************************************************************/
 local_rd& local_rd::operator=(local_rd&& lrd_rhs) noexcept {
 	if( this!=&lrd_rhs ){
 		name			= move(lrd_rhs.name);
 		FD				= lrd_rhs.FD;
-		charge			= lrd_rhs.charge;
 		LH				= lrd_rhs.LH;
-		rd_names		= move(lrd_rhs.rd_names);
+		band			= lrd_rhs.band;
+		TFD				= lrd_rhs.TFD;
+		charge			= lrd_rhs.charge;
 		lrds			= move(lrd_rhs.lrds);
+		rd_names		= move(lrd_rhs.rd_names);
+		requested		= move(lrd_rhs.requested);
+		needed			= move(lrd_rhs.needed);
 	}
 	return *this;
 }
 /***********************************************************************************/
+void local_rd::set_requests(){
+	static bool warned = false; // the option messages are given for the first object only
+	bool warn = false;
+	#pragma omp critical (lrd_requests)
+	{
+		warn	= !warned;
+		warned	= true;
+	}
+	// the pymol scripts use the statistics of most of the grids
+	bool all = lrd_list.empty() || pymol_script;
+	if ( pymol_script && !lrd_list.empty() && warn ){
+		m_log->write_warning("The pymol scripts need all the volumetric descriptors, the lrds option is ignored!\n");
+	}
+	requested.assign( rd_names.size(), all );
+	if ( !all ){
+		std::stringstream list(lrd_list);
+		string item;
+		while( std::getline(list,item,',') ){
+			unsigned int i = std::find( rd_names.begin(), rd_names.end(), item ) - rd_names.begin();
+			if ( i < rd_names.size() ) requested[i] = true;
+			else if ( warn ) m_log->write_warning("Unknown volumetric descriptor requested: " + item + "\n");
+		}
+	}
+	// the prerequisites always have lower indices, so one backward sweep closes the dependencies
+	needed = requested;
+	for( int i=rd_names.size()-1; i>=0; i-- ){
+		if ( !needed[i] ) continue;
+		for( unsigned int j=0; j<descriptor_deps[i].size(); j++ ) needed[ descriptor_deps[i][j] ] = true;
+	}
+}
+/***********************************************************************************/
 void local_rd::calculate_fukui_Band(const Icube& homo_b, const Icube& lumo_b){
 	lrds[5] = homo_b;
 	lrds[6] = lumo_b;
-	lrds[20] = (homo_b+lumo_b)/2.0;
+	if ( needed[20] ) lrds[20] = (homo_b+lumo_b)/2.0;
 	lrds[5].normalize(5);
 	lrds[6].normalize(5);
-	lrds[7] = (lrds[5]+lrds[6])/2.0;
-	lrds[8] = lrds[6]-lrds[5];
-}
-/***********************************************************************************/
-void local_rd::calculate_RD(const global_rd& grd){
-	lrds[14] = lrds[5]*grd.grds[5];
-	lrds[14] = lrds[5]*grd.grds[5] - (lrds[6]*grd.grds[6]);
-	lrds[15] = lrds[8]*grd.grds[9];
-	lrds[16] = lrds[7]*grd.grds[9];
-	lrds[17] = lrds[8]*(grd.grds[9]*grd.grds[9]);
-	lrds[18] = lrds[8]*grd.grds[10];
+	// the combinations of the band Fukui functions are left to the pointwise kernel
+	lrds[7].scalar.clear();
+	lrds[8].scalar.clear();
 }
 /***********************************************************************************/
-void local_rd::calculate_Fukui_potential(){
+void local_rd::calculate_pointwise(const global_rd* grd){
+	// the Fukui functions come from the band calculation or a former call when already set,
+	// otherwise from the densities of the finite differences or the frontier orbitals
+	bool given		= !lrds[5].scalar.empty() && !lrds[6].scalar.empty();
+	const Icube& ref= given ? lrds[5] : ( FD ? lrds[2] : lrds[0] );
+	if ( ref.scalar.empty() ) return;
+	if ( !given && ( FD ? lrds[3].scalar.empty() || lrds[4].scalar.empty() : lrds[1].scalar.empty() ) ) return;
 	
-	vector<double> elec_H(lrds[5].voxelN);
-	vector<double> nuc_H(lrds[5].voxelN);
-	vector<double> rad_H(lrds[5].voxelN);
-	unsigned int i,j,k,x,y,z;
-	double ii	= 0;
-	double jj	= 0;
-	double kk	= 0;
-	double xx	= 0;
-	double yy	= 0;
-	double zz	= 0;
-	double r	= 0;
-	double s1	= lrds[5].gridsides[0];
-	double s2	= lrds[5].gridsides[1];
-	double s3	= lrds[5].gridsides[2];
-	double o1	= lrds[5].origin[0];
-	double o2	= lrds[5].origin[1];
-	double o3	= lrds[5].origin[2];
-	unsigned int g1 = lrds[5].grid[0];
-	unsigned int g2 = lrds[5].grid[1];
-	unsigned int g3 = lrds[5].grid[2];
-		
-	#pragma omp declare reduction(vec_d_plus : std::vector<double> : \
-				std::transform(omp_out.begin(), omp_out.end(), omp_in.begin(), omp_out.begin(), std::plus<double>())) \
-				initializer(omp_priv = omp_orig)
-
-	#pragma omp parallel default(shared) private(i,j,k,x,y,z,r,xx,yy,zz,ii,jj,kk)
-	{
-	#pragma omp parallel for reduction(vec_d_plus:elec_H,nuc_H,rad_H)
-	for(i=0;i<g1;i++){
-		for(j=0;j<g2;j++){
-			for(k=0;k<g3;k++){
-				for (x=0;x<g1;x++){
-					for (y=0;y<g2;y++){
-						for (z=0;z<g3;z++){
-							xx	= x*s1 + o1;
-							yy	= y*s2 + o2;
-							zz	= z*s3 + o3;
-							ii	= i*s1 + o1;
-							jj	= j*s2 + o2;
-							kk	= k*s3 + o3;
-							xx 	-= ii;
-							xx 	*= xx;
-							yy 	-= jj;
-							yy 	*= yy;
-							zz 	-= kk;
-							zz 	*= zz;
-							r  	= sqrt(xx + yy + zz);
-							if ( r == 0.000 ){
-								elec_H[i*g1*g1+j*g2+k]	+= 0;
-								nuc_H[i*g1*g1+j*g2+k] 	+= 0;
-								rad_H[i*g1*g1+j*g2+k] 	+= 0;
-							}else{
-								elec_H[i*g1*g1+j*g2+k]	+= lrds[5].scalar[x*g1*g1+y*g2+z]/r;
-								nuc_H[i*g1*g1+j*g2+k]	+= lrds[6].scalar[x*g1*g1+y*g2+z]/r;
-								rad_H[i*g1*g1+j*g2+k]	+= lrds[7].scalar[x*g1*g1+y*g2+z]/r;
-							}
-						}
-					}
-				}
-			}
-		}
+	bool outs[22];
+	for( unsigned int i=0; i<22; i++ ) outs[i] = false;
+	outs[5] = outs[6] = !given;
+	outs[7] = needed[7] && lrds[7].scalar.empty();
+	outs[8] = needed[8] && lrds[8].scalar.empty();
+	if ( grd ){
+		for( unsigned int i=14; i<19; i++ ) outs[i] = needed[i];
 	}
+	bool any = false;
+	for( unsigned int i=0; i<22; i++ ) any = any || outs[i];
+	if ( !any ) return;
+	for( unsigned int i=0; i<22; i++ ){
+		if ( outs[i] ) lrds[i].set_grid(ref);
 	}
+	const double* in0 = given ? lrds[5].scalar.data() : ( FD ? lrds[2].scalar.data() : lrds[0].scalar.data() );
+	const double* in1 = given ? lrds[6].scalar.data() : ( FD ? lrds[3].scalar.data() : lrds[1].scalar.data() );
+	const double* in2 = FD && !given ? lrds[4].scalar.data() : nullptr;
+	double* p[22];
+	for( unsigned int i=0; i<22; i++ ) p[i] = outs[i] ? lrds[i].scalar.data() : nullptr;
+	double g5	= grd ? grd->grds[5]  : 0.0;
+	double g6	= grd ? grd->grds[6]  : 0.0;
+	double g9	= grd ? grd->grds[9]  : 0.0;
+	double g10	= grd ? grd->grds[10] : 0.0;
+	unsigned int n = ref.voxelN;
 	
-	double volume = std::abs(s1*s2*s3);
-	lrds[11] = lrds[5];
-	lrds[12] = lrds[5];
-	lrds[13] = lrds[5];
-	for(i=0;i<elec_H.size();i++) { lrds[11].scalar[i] = elec_H[i]; }
-	for(i=0;i<nuc_H.size();i++) { lrds[12].scalar[i] = nuc_H[i]; }
-	for(i=0;i<rad_H.size();i++) { lrds[13].scalar[i] = rad_H[i]; }
-	
-	lrds[11] = lrds[11]*volume;
-	lrds[12] = lrds[12]*volume;
-	lrds[13] = lrds[13]*volume;
-	
+	omp_set_num_threads(NP);
+	#pragma omp parallel for
+	for( unsigned int i=0; i<n; i++ ){
+		double fm, fp;
+		if ( given ){
+			fm = in0[i];
+			fp = in1[i];
+		}else if ( in2 ){
+			fm = in0[i] - in1[i];
+			fp = in2[i] - in0[i];
+		}else{
+			fm = in0[i]*in0[i];
+			fp = in1[i]*in1[i];
+		}
+		double f0	= (fm+fp)/2.0;
+		double dual	= fp-fm;
+		if ( p[5] )  p[5][i]  = fm;
+		if ( p[6] )  p[6][i]  = fp;
+		if ( p[7] )  p[7][i]  = f0;
+		if ( p[8] )  p[8][i]  = dual;
+		if ( p[14] ) p[14][i] = fm*g5 - fp*g6;
+		if ( p[15] ) p[15][i] = dual*g9;
+		if ( p[16] ) p[16][i] = f0*g9;
+		if ( p[17] ) p[17][i] = dual*(g9*g9);
+		if ( p[18] ) p[18][i] = dual*g10;
+	}
+}
+/***********************************************************************************/
+void local_rd::calculate_RD(const global_rd& grd){
+	this->calculate_pointwise(&grd);
+}
+/***********************************************************************************/
+void local_rd::calculate_Fukui_potential(){
+	if ( !needed[11] && !needed[12] && !needed[13] ) return;
+	this->calculate_pointwise(nullptr);
+	poisson_fft coulomb(lrds[5]);
+	if ( needed[11] ) lrds[11] = coulomb.potential(lrds[5]);
+	if ( needed[12] ) lrds[12] = coulomb.potential(lrds[6]);
+	if ( needed[13] ) lrds[13] = coulomb.potential(lrds[7]);
 }
 /***********************************************************************************/
 void local_rd::calculate_hardness(const global_rd& grd){
@@ -299,80 +353,29 @@ void local_rd::calculate_hardness(const global_rd& grd){
 	double val1			= grd.grds[7]/numofelec;
 	double val2			= grd.grds[8]*2;
 		
-	Icube elec_dens_norm= lrds[2]/ numofelec ;
-	Icube elec_dens_hard= elec_dens_norm*val2;
-	Icube homo_elec_dens= lrds[5] - elec_dens_norm;
-	homo_elec_dens		= homo_elec_dens*val1;
-	lrds[9]				= homo_elec_dens + elec_dens_hard;
-	
-
-	//local hardness com aproximação de potencial elétron-elétron
-	vector<double> elec_H(lrds[5].voxelN);
-	unsigned int i,j,k,x,y,z;
-	double ii	= 0;
-	double jj	= 0;
-	double kk	= 0;
-	double xx	= 0;
-	double yy	= 0;
-	double zz	= 0;
-	double r	= 0;
-	double s1	= lrds[5].gridsides[0];
-	double s2	= lrds[5].gridsides[1];
-	double s3	= lrds[5].gridsides[2];
-	double o1	= lrds[5].origin[0];
-	double o2	= lrds[5].origin[1];
-	double o3	= lrds[5].origin[2];
-	unsigned int g1 = lrds[5].grid[0];
-	unsigned int g2 = lrds[5].grid[1];
-	unsigned int g3 = lrds[5].grid[2];
-	
-	#pragma omp declare reduction(vec_d_plus : std::vector<double> : \
-				std::transform(omp_out.begin(), omp_out.end(), omp_in.begin(), omp_out.begin(), std::plus<double>())) \
-                initializer(omp_priv = omp_orig)
-
-	#pragma omp parallel default(shared) private(i,j,k,x,y,z,r,xx,yy,zz,ii,jj,kk)
-	{
-	#pragma omp parallel for reduction(vec_d_plus:elec_H)
-	for(i=0;i<g1;i++){
-		for(j=0;j<g2;j++){
-			for(k=0;k<g3;k++){
-				for (x=0;x<g1;x++){
-					for (y=0;y<g2;y++){
-						for (z=0;z<g3;z++){
-							xx	= x*s1 + o1;
-							yy	= y*s2 + o2;
-							zz	= z*s3 + o3;
-							ii	= i*s1 + o1;
-							jj	= j*s2 + o2;
-							kk	= k*s3 + o3;
-							xx	-= ii;
-							xx 	*= xx;
-							yy 	-= jj;
-							yy 	*= yy;
-							zz 	-= kk;
-							zz 	*= zz;
-							r  	= sqrt(xx + yy + zz);
-							if ( r == 0.000 ){
-								elec_H[i*g1*g1+j*g2+k] += 0;
-							}else{
-								elec_H[i*g1*g1+j*g2+k] += lrds[2].scalar[x*g1*g1+y*g2+z]/r;
-							}
-						}
-					}
-				}
-			}
+	if ( needed[9] ){
+		this->calculate_pointwise(nullptr);
+		lrds[9].set_grid(lrds[2]);
+		const double* dens	= lrds[2].scalar.data();
+		const double* fm	= lrds[5].scalar.data();
+		double* hard		= lrds[9].scalar.data();
+		omp_set_num_threads(NP);
+		#pragma omp parallel for
+		for( unsigned int i=0; i<lrds[2].voxelN; i++ ){
+			double dens_norm = dens[i]/numofelec;
+			hard[i] = (fm[i] - dens_norm)*val1 + dens_norm*val2;
 		}
 	}
+
+	//local hardness com aproximação de potencial elétron-elétron
+	if ( needed[10] ){
+		poisson_fft coulomb(lrds[2]);
+		lrds[10] = coulomb.potential(lrds[2]);
+		lrds[10] = lrds[10]*(1/numofelec);
 	}
-	
-	double volume = std::abs(s1*s2*s3);
-	lrds[10] = lrds[2];
-	for(i=0;i<elec_H.size();i++) { lrds[10].scalar[i] = elec_H[i]; }
-	lrds[10] = lrds[10]*volume;
-	lrds[10] = lrds[10]*(1/numofelec);
 	//----------------------------------------------------------------------------
 	
-	if ( TFD ){
+	if ( TFD && needed[21] ){
 		Icube density_rc1	= lrds[2].scale_cube(0.6666667);
 		Icube density_rc2	= lrds[2].scale_cube(0.3333333);
 		double Ck	= 2.8172;
@@ -387,66 +390,19 @@ void local_rd::calculate_hardness(const global_rd& grd){
 }
 /***********************************************************************************/
 void local_rd::calculate_MEP(const Imolecule& mol){
-	
-	vector<double> MEP(lrds[5].voxelN);
-	unsigned int x,y,z;
-	double ii	= 0;
-	double jj	= 0;
-	double kk	= 0;
-	double xx	= 0;
-	double yy	= 0;
-	double zz	= 0;
-	double r	= 0;
-	double s1	= lrds[5].gridsides[0];
-	double s2	= lrds[5].gridsides[1];
-	double s3	= lrds[5].gridsides[2];
-	double o1	= lrds[5].origin[0];
-	double o2	= lrds[5].origin[1];
-	double o3	= lrds[5].origin[2];
-	unsigned int g1 = lrds[5].grid[0];
-	unsigned int g2 = lrds[5].grid[1];
-	unsigned int g3 = lrds[5].grid[2];
-	
-	#pragma omp declare reduction(vec_d_plus : std::vector<double> : \
-				std::transform(omp_out.begin(), omp_out.end(), omp_in.begin(), omp_out.begin(), std::plus<double>())) \
-                initializer(omp_priv = omp_orig)
-
-	#pragma omp parallel default(shared) private(x,y,z,r,xx,yy,zz,ii,jj,kk)
-	{
-	#pragma omp parallel for reduction(vec_d_plus:MEP)
-	for (x=0;x<g1;x++){
-		for (y=0;y<g2;y++){
-			for (z=0;z<g3;z++){
-				xx	= x*s1 + o1;
-				yy	= y*s2 + o2;
-				zz	= z*s3 + o3;
-				for (int na=0; na<mol.atoms.size(); na++ ){
-					ii	= mol.atoms[na].xcoord - xx;
-					jj	= mol.atoms[na].ycoord - yy;
-					kk	= mol.atoms[na].zcoord - zz;
-					ii *= ii;
-					jj *= jj;
-					kk *= kk;
-					r = sqrt(ii+jj+kk);
-					if ( r == 0.000 ){
-						MEP[x*g1*g1+y*g2+z] += 0;
-					}else{
-						MEP[x*g1*g1+y*g2+z] += mol.atoms[na].charge /r;
-						
-					}
-				}
-			}
-		}
-	}
-	}
-	
-	lrds[19] = lrds[2];
-	for(unsigned i=0;i<MEP.size();i++) { lrds[19].scalar[i] = MEP[i]; }
+	if ( !needed[19] ) return;
+	vector<double> charges( mol.atoms.size() );
+	for( unsigned int i=0; i<mol.atoms.size(); i++ ) charges[i] = mol.atoms[i].charge;
+	cell_list atoms(mol,charges);
+	lrds[19].set_grid(lrds[2]);
+	atoms.potential(lrds[19],0.0);
 }
 /***********************************************************************************/
 local_rd operator-(const local_rd& lrd_lhs,const local_rd& lrd_rhs){
 	local_rd Result(lrd_lhs);
 	for(unsigned int i=0; i<lrd_lhs.lrds.size(); i++){
+		// descriptors not calculated have no grid
+		if ( lrd_lhs.lrds[i].scalar.empty() || lrd_rhs.lrds[i].scalar.empty() ) continue;
 		Result.lrds[i] = lrd_lhs.lrds[i] - lrd_rhs.lrds[i];
 	}
 	return Result;
@@ -466,37 +422,7 @@ void local_rd::write_LRD(){
 	}
 	
 	string name_type = name + typestr2;
-	std::vector<string>	cube_names;
 
-	cube_names.push_back(name_type+rd_names[0]+"_ph1");	// 0
-	cube_names.push_back(name_type+rd_names[0]+"_ph2");	// 1
-	cube_names.push_back(name_type+rd_names[1]+"_ph1");	// 2
-	cube_names.push_back(name_type+rd_names[1]+"_ph2");	// 3
-	cube_names.push_back(name_type+rd_names[2]);		// 4
-	cube_names.push_back(name_type+rd_names[3]);		// 5
-	cube_names.push_back(name_type+rd_names[4]);		// 6
-	cube_names.push_back(name_type+rd_names[5]);		// 7
-	cube_names.push_back(name_type+rd_names[6]);		// 8
-	cube_names.push_back(name_type+rd_names[7]);		// 9
-	cube_names.push_back(name_type+rd_names[8]+"_ph1");	// 10
-	cube_names.push_back(name_type+rd_names[8]+"_ph2");	// 11
-	cube_names.push_back(name_type+rd_names[9]);		// 12
-	cube_names.push_back(name_type+rd_names[10]);		// 13
-	cube_names.push_back(name_type+rd_names[11]);		// 14
-	cube_names.push_back(name_type+rd_names[12]);		// 15
-	cube_names.push_back(name_type+rd_names[13]);		// 16
-	cube_names.push_back(name_type+rd_names[14]);		// 17
-	cube_names.push_back(name_type+rd_names[15]+"_ph1");// 18
-	cube_names.push_back(name_type+rd_names[15]+"_ph2");// 19
-	cube_names.push_back(name_type+rd_names[16]);		// 20
-	cube_names.push_back(name_type+rd_names[17]);		// 21
-	cube_names.push_back(name_type+rd_names[18]+"_ph1");// 22
-	cube_names.push_back(name_type+rd_names[18]+"_ph2");// 23
-	cube_names.push_back(name_type+rd_names[19]+"_ph1");// 24
-	cube_names.push_back(name_type+rd_names[19]+"_ph2");// 25
-	cube_names.push_back(name_type+rd_names[20]);		// 26
-	cube_names.push_back(name_type+rd_names[21]);		// 27
-	
 	lrds[0].header	= "Highest energy Occupied Molecular Orbital\n" + typestr;
 	lrds[1].header	= "Lowest energy Unnocupied Molecular Orbital\n"+ typestr;
 	lrds[2].header	= "Total electron density calculated with PRIMoRDiA\n"+ typestr;
@@ -523,50 +449,67 @@ void local_rd::write_LRD(){
 	for(unsigned i=0;i<lrds.size();i++){
 		lrds[i].name = rd_names[i];
 	}
-		
+	
+	// each field is written once, the pymol scripts load the signed descriptors twice, one object per phase
+	vector<unsigned int> outs;
 	if ( FD ){
-		lrds[2].write_cube(cube_names[4]+".cube"); //electron density
-		lrds[3].write_cube(cube_names[5]+".cube"); //electron density cation
-		lrds[4].write_cube(cube_names[6]+".cube"); //electron density anion
+		outs.push_back(2); //electron density
+		outs.push_back(3); //electron density cation
+		outs.push_back(4); //electron density anion
 	}else{
-		lrds[0].write_cube(cube_names[0]+".cube"); // HOMO ph1
-		lrds[0].write_cube(cube_names[1]+".cube"); // HOMO ph2
-		lrds[1].write_cube(cube_names[2]+".cube"); // LUMO ph1
-		lrds[1].write_cube(cube_names[3]+".cube"); // LUMO ph2
+		outs.push_back(0); // HOMO
+		outs.push_back(1); // LUMO
 	}
-	
 	//Default ouutput
-	lrds[5].write_cube(cube_names[7]+".cube"); // left Fukui
-	lrds[6].write_cube(cube_names[8]+".cube"); // right Fukui
-	lrds[7].write_cube(cube_names[9]+".cube"); // zero Fukui
-	lrds[8].write_cube(cube_names[10]+".cube"); // dual Fukui ph1
-	lrds[8].write_cube(cube_names[11]+".cube"); // dual Fukui ph2
-	lrds[11].write_cube(cube_names[14]+".cube"); // left Fukui potential 
-	lrds[14].write_cube(cube_names[17]+".cube"); // local hardnes int
-	lrds[15].write_cube(cube_names[18]+".cube"); // local softness dual ph1
-	lrds[15].write_cube(cube_names[19]+".cube"); // local softness dual ph2
-
-
+	outs.push_back(5);	// left Fukui
+	outs.push_back(6);	// right Fukui
+	outs.push_back(7);	// zero Fukui
+	outs.push_back(8);	// dual Fukui
+	outs.push_back(11);	// left Fukui potential 
+	outs.push_back(14);	// local hardnes int
+	outs.push_back(15);	// local softness dual
 	if ( LH ){
-		lrds[9].write_cube(cube_names[12]+".cube"); //local hardness lcp
-		lrds[10].write_cube(cube_names[13]+".cube"); // local hardness Vee
-		lrds[19].write_cube(cube_names[24]+".cube"); // MEP ph1
-		lrds[19].write_cube(cube_names[25]+".cube"); // MEP ph2
+		outs.push_back(9);	//local hardness lcp
+		outs.push_back(10);	// local hardness Vee
+		outs.push_back(19);	// MEP
 		if ( TFD ){
-			lrds[21].write_cube(cube_names[27]+".cube"); // local hardness TFD complete functional
+			outs.push_back(21); // local hardness TFD complete functional
 		}
 	}
-	
 	if ( extra_RD ){
-		lrds[12].write_cube(cube_names[15]+".cube"); // right Fukui potential
-		lrds[13].write_cube(cube_names[16]+".cube"); // zero Fukui potential
-		lrds[16].write_cube(cube_names[20]+".cube"); // local sofntess average
-		lrds[17].write_cube(cube_names[21]+".cube"); // hyper local softness
-		lrds[18].write_cube(cube_names[22]+".cube"); // multiphilicity ph1
-		lrds[18].write_cube(cube_names[23]+".cube"); // multiphilicity ph2
+		outs.push_back(12); // right Fukui potential
+		outs.push_back(13); // zero Fukui potential
+		outs.push_back(16); // local sofntess average
+		outs.push_back(17); // hyper local softness
+		outs.push_back(18); // multiphilicity
 	}
 	if ( band ){
-		lrds[20].write_cube(cube_names[26]+".cube"); // MO band localization
+		outs.push_back(20); // MO band localization
+	}
+	
+	// only the requested descriptors are written
+	unsigned int nouts = 0;
+	for( unsigned int i=0; i<outs.size(); i++ ){
+		if ( requested[ outs[i] ] && !lrds[ outs[i] ].scalar.empty() ) outs[nouts++] = outs[i];
+	}
+	outs.resize(nouts);
+	if ( outs.empty() ) return;
+	
+	// the grids are copied to the background writer and the calculations go on
+	if ( vol_out > 0 ){
+		std::shared_ptr< vector<Icube> > fields = std::make_shared< vector<Icube> >();
+		for( unsigned int i=0; i<outs.size(); i++ ) fields->push_back( lrds[ outs[i] ] );
+		string vol_name	= name_type + "descriptors.pvol";
+		bool single		= vol_out == 2;
+		std::size_t bytes = outs.size()*lrds[ outs[0] ].scalar.size()*sizeof(double);
+		out_writer.submit( [fields,vol_name,single]{
+			volume_writer volume(vol_name,(*fields)[0],single,true);
+			for( unsigned int i=0; i<fields->size(); i++ ) volume.add_field( (*fields)[i], (*fields)[i].name );
+		}, bytes );
+	}else{
+		for( unsigned int i=0; i<outs.size(); i++ ){
+			out_writer.submit_cube( lrds[ outs[i] ], name_type + lrds[ outs[i] ].name + ".cube" );
+		}
 	}
 
 	m_log->input_message("Finishing writting the local reactivity descriptos grids.\n");
@@ -23,7 +23,10 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstdlib>
+#include <sstream>
+#include <memory>
 #include <experimental/filesystem>
+#include <omp.h>
 // include statements from PRIMORDiA-libs
 #include "../include/common.h"
 #include "../include/Iaorbital.h"
@@ -33,6 +36,8 @@
 #include "../include/local_rd_cnd.h"
 #include "../include/Iprotein.h"
 #include "../include/residue_lrd.h"
+#include "../include/output_writer.h"
+#include "../include/cell_list.h"
 
 using std::cout;
 using std::endl;
@@ -122,7 +127,8 @@ local_rd_cnd::local_rd_cnd(const local_rd_cnd& lrd_rhs)	:
 	TFD(lrd_rhs.TFD)									,
 	names(lrd_rhs.names)								,
 	charge(lrd_rhs.charge)								,
-	lrds(lrd_rhs.lrds)									{
+	lrds(lrd_rhs.lrds)									,
+	atom_pairs(lrd_rhs.atom_pairs)						{
 }
 /***********************************************************************************/
 local_rd_cnd& local_rd_cnd::operator=(const local_rd_cnd& lrd_rhs){
@@ -133,6 +139,7 @@ local_rd_cnd& local_rd_cnd::operator=(const local_rd_cnd& lrd_rhs){
 		names	= lrd_rhs.names;
 		charge	= lrd_rhs.charge;
 		lrds	= lrd_rhs.lrds;
+		atom_pairs	= lrd_rhs.atom_pairs;
 	}
 	return *this;
 }                
@@ -143,7 +150,8 @@ local_rd_cnd::local_rd_cnd(local_rd_cnd&& lrd_rhs) noexcept	:
 	TFD( move(lrd_rhs.TFD) )								,
 	names( move(lrd_rhs.names) )							,
 	charge( move(lrd_rhs.charge) )							,
-	lrds( move(lrd_rhs.lrds) )								{
+	lrds( move(lrd_rhs.lrds) )								,
+	atom_pairs( move(lrd_rhs.atom_pairs) )					{
 }
 /***********************************************************************************/
 local_rd_cnd& local_rd_cnd::operator=(local_rd_cnd&& lrd_rhs) noexcept {
@@ -154,6 +162,7 @@ local_rd_cnd& local_rd_cnd::operator=(local_rd_cnd&& lrd_rhs) noexcept {
 		names	= move(lrd_rhs.names);
 		charge	= move(lrd_rhs.charge);
 		lrds	= move(lrd_rhs.lrds);
+		atom_pairs	= move(lrd_rhs.atom_pairs);
 	}
 	return *this;
 }
@@ -168,94 +177,136 @@ local_rd_cnd operator-(const local_rd_cnd& lrd_lhs,const local_rd_cnd& lrd_rhs){
 	return Result;
 }
 /***********************************************************************************/
+// offsets of the atomic orbitals of the atoms built by Imolecule::update, or built in local
+// for molecules that did not pass through it
+const vector<unsigned>& atom_ao_offset(const Imolecule& molecule, vector<unsigned>& local){
+	if ( molecule.ao_offset.size() == molecule.atoms.size()+1 ) return molecule.ao_offset;
+	local.resize(molecule.atoms.size()+1);
+	local[0] = 0;
+	for( unsigned i=0; i<molecule.atoms.size(); i++ ) local[i+1] = local[i] + molecule.atoms[i].orbitals.size();
+	return local;
+}
+/***********************************************************************************/
+vector<double> local_rd_cnd::atomic_populations(const Imolecule& molecule, const vector<double>& weights, bool beta){
+	unsigned ao		= molecule.num_of_ao;
+	unsigned nof	= molecule.atoms.size();
+	vector<unsigned> local_off;
+	const vector<unsigned>& aoff	= atom_ao_offset(molecule,local_off);
+	const vector<double>& coeff		= beta ? molecule.coeff_MO_beta : molecule.coeff_MO;
+	
+	//position of the diagonal block of each atom in the accumulated matrix
+	vector<std::size_t> blk(nof+1,0);
+	for( unsigned atom=0; atom<nof; atom++ ){
+		std::size_t n = aoff[atom+1] - aoff[atom];
+		blk[atom+1] = blk[atom] + n*n;
+	}
+	vector<unsigned> mos;
+	for( unsigned i=0; i<weights.size(); i++ ){
+		if ( weights[i] != 0.0 ) mos.push_back(i);
+	}
+	
+	//atom of each atomic orbital, to split the localized MOs in runs of the same atom
+	bool sparse = !beta && molecule.sparse_MO();
+	vector<unsigned> ao_atom;
+	if ( sparse ){
+		ao_atom.resize(ao);
+		for( unsigned atom=0; atom<nof; atom++ ){
+			for( unsigned mu=aoff[atom]; mu<aoff[atom+1]; mu++ ) ao_atom[mu] = atom;
+		}
+	}
+	
+	//diagonal blocks of C^T W C, each thread reading its share of the molecular orbitals once
+	vector<double> G(blk[nof],0.0);
+	omp_set_num_threads(NP);
+	#pragma omp parallel
+	{
+	vector<double> g(blk[nof],0.0);
+	#pragma omp for schedule(static)
+	for( unsigned k=0; k<mos.size(); k++ ){
+		if ( sparse ){
+			const unsigned* idx	= molecule.lmo_ao.data();
+			const double* c		= molecule.lmo_coeff.data();
+			double w			= weights[mos[k]];
+			unsigned end		= molecule.lmo_first[mos[k]+1];
+			for( unsigned first=molecule.lmo_first[mos[k]]; first<end; ){
+				unsigned atom	= ao_atom[idx[first]];
+				unsigned last	= first;
+				while ( last < end && ao_atom[idx[last]] == atom ) last++;
+				unsigned off	= aoff[atom];
+				unsigned n		= aoff[atom+1] - off;
+				double* ga		= &g[blk[atom]];
+				for( unsigned p=first; p<last; p++ ){
+					double wc = w*c[p];
+					for( unsigned q=first; q<last; q++ ) ga[(idx[p]-off)*n+idx[q]-off] += wc*c[q];
+				}
+				first = last;
+			}
+			continue;
+		}
+		const double* c	= &coeff[std::size_t(ao)*mos[k]];
+		double w		= weights[mos[k]];
+		for( unsigned atom=0; atom<nof; atom++ ){
+			unsigned off	= aoff[atom];
+			unsigned n		= aoff[atom+1] - off;
+			double* ga		= &g[blk[atom]];
+			for( unsigned mu=0; mu<n; mu++ ){
+				double wc = w*c[off+mu];
+				for( unsigned nu=0; nu<n; nu++ ) ga[mu*n+nu] += wc*c[off+nu];
+			}
+		}
+	}
+	#pragma omp critical
+	for( std::size_t j=0; j<g.size(); j++ ) G[j] += g[j];
+	}
+	
+	//contracting each block with the overlap matrix, stored as a packed lower triangle
+	vector<double> pop(nof,0.0);
+	for( unsigned atom=0; atom<nof; atom++ ){
+		unsigned off	= aoff[atom];
+		unsigned n		= aoff[atom+1] - off;
+		for( unsigned mu=0; mu<n; mu++ ){
+			for( unsigned nu=0; nu<n; nu++ ){
+				unsigned r	= std::max(mu,nu) + off;
+				unsigned c	= std::min(mu,nu) + off;
+				pop[atom]	+= G[blk[atom]+mu*n+nu]*molecule.m_overlap[c+(r*(r+1))/2];
+			}
+		}
+	}
+	return pop;
+}
+/***********************************************************************************/
 void local_rd_cnd::calculate_frontier_orbitals( Imolecule& molecule, unsigned band){
 	name					= molecule.name;
-	double value_h			= 0.0;
-	double value_l			= 0.0;
-	unsigned init_orb		= 0;
-	unsigned n_aorbs		= 0;
-	unsigned ao 			= molecule.get_ao_number();
+	molecule.get_ao_number();
 	unsigned homon 			= abs(molecule.homoN);
 	unsigned lumon 			= abs(molecule.lumoN);
-	unsigned cnt 			= 0;
 	unsigned init			= homon-band;
 	unsigned fin 			= lumon+band;
 	
-	for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
-		//defining the indices of the atomic orbitals
-		init_orb	= 0;
-		n_aorbs		= 0;
-		if ( atom == 0 ) {
-			init_orb = 0;
-			n_aorbs  = molecule.atoms[0].orbitals.size();
-		}else{
-			for( unsigned j=0; j<atom; j++ ){
-				init_orb += molecule.atoms[j].norb;
-			}
-			for( unsigned j=0; j<=atom; j++ ){
-				n_aorbs  += molecule.atoms[j].norb;
-			}
-		}
-		//-------------------------------------------------
-		//calculating the occupied molecular orbitals
-		for( unsigned i=init; i<=homon; i++ ){
-			for( unsigned mu=init_orb; mu<n_aorbs; mu++ ){
-				for ( unsigned nu=init_orb; nu<n_aorbs; nu++ ) {
-					value_h+=molecule.coeff_MO[ao*i + mu]*
-							molecule.coeff_MO[ao*i + nu]*
-							molecule.m_overlap[ nu+( mu*(mu+1) )/2];
-				}
-			}
-		}
-		//-------------------------------------------------
-		//calculating the virtual molecular orbitals
+	//weights of the molecular orbitals in the populations of the frontier bands
+	vector<double> w_h( fin+1, 0.0 );
+	vector<double> w_l( fin+1, 0.0 );
+	for( unsigned i=init; i<=homon; i++ ) w_h[i] = 1.0;
+	for( unsigned i=lumon; i<=fin; i++ ) w_l[i] = 1.0;
+	lrds[0] = this->atomic_populations(molecule,w_h,false);
+	lrds[1] = this->atomic_populations(molecule,w_l,false);
+	
+	//--------------------------------------------------
+	// calculting the beta orbitals
+	if ( molecule.betad ){
 		for( unsigned i=lumon; i<=fin; i++ ){
-			for( unsigned mu=init_orb; mu<n_aorbs; mu++ ){
-				for ( unsigned nu=init_orb; nu<n_aorbs; nu++ ) {
-					value_l +=molecule.coeff_MO[ao*i + mu]*
-							molecule.coeff_MO[ao*i + nu]*
-							molecule.m_overlap[nu+(mu*(mu+1))/2];
-				}
-			}
+			if ( molecule.orb_energies_beta[i] > molecule.lumo_energy+energy_crit ) w_l[i] = 0.0;
 		}
-		
-		//--------------------------------------------------
-		// calculting the beta orbitals
-		if ( molecule.betad ){
-			//calculating the occupied molecular orbitals
-			for( unsigned i=init; i<=homon; i++ ){
-				for( unsigned mu=init_orb; mu<n_aorbs; mu++){
-					for ( unsigned nu=init_orb; nu<n_aorbs; nu++ ) {
-						value_h+=molecule.coeff_MO_beta[ao*i + mu]*
-								molecule.coeff_MO_beta[ao*i + nu]*
-								molecule.m_overlap[nu+(mu*(mu+1) )/2];
-					}
-				}
-			}
-			value_h /= 2;
-			//------------------------------------------------
-			
-			//calculating the virtual molecular orbitals
-			for( unsigned i=lumon; i<=fin; i++ ){
-				if ( molecule.orb_energies_beta[i] <= molecule.lumo_energy+energy_crit ){
-					for(unsigned mu=init_orb; mu<n_aorbs; mu++ ){
-						for (unsigned nu=init_orb; nu<n_aorbs; nu++ ) {
-							value_l +=molecule.coeff_MO_beta[ao*i + mu]*
-									molecule.coeff_MO_beta[ao*i + nu]*
-									molecule.m_overlap[nu+(mu*(mu+1))/2];
-						}
-					}
-				}
-			}
-			value_l /= 2;
+		vector<double> beta_h = this->atomic_populations(molecule,w_h,true);
+		vector<double> beta_l = this->atomic_populations(molecule,w_l,true);
+		for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
+			lrds[0][atom] = ( lrds[0][atom] + beta_h[atom] )/2;
+			lrds[1][atom] = ( lrds[1][atom] + beta_l[atom] )/2;
 		}
-		
-		lrds[0][atom] = value_h;
-		lrds[1][atom] = value_l;
+	}
+	for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
 		lrds[13][atom]= molecule.atoms[atom].charge;
-		lrds[12][atom]= value_h + value_l;
-		value_h = 0;
-		value_l = 0;
+		lrds[12][atom]= lrds[0][atom] + lrds[1][atom];
 	}
 	if ( band >= 1 ){
 		lrds[0] = norm_dvec(lrds[0],3);
@@ -286,134 +337,65 @@ void local_rd_cnd::energy_weighted_fukui_functions( const Imolecule& molecule ){
 	name =	molecule.name;
 	double pre_coef		= exp( -abs(energy_crit) );
 	double coefficient	= 0.0;
-	int mo_count 		= 0;
-	double value_h		= 0.0;
-	double value_l		= 0.0;
-	unsigned init_orb	= 0;
-	unsigned n_aorbs	= 0;
-	unsigned ao 		= molecule.num_of_ao;
 	unsigned homon 		= abs(molecule.homoN);
 	unsigned lumon 		= abs(molecule.lumoN);
-
-	for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
-		// defining the atomic orbitals indices
-		init_orb	= 0;
-		n_aorbs		= 0;
-		mo_count	= 0;
-		if ( atom == 0 ){
-			init_orb = 0;
-			n_aorbs  = molecule.atoms[0].orbitals.size();
-		}else{
-			for( unsigned j=0; j<atom; j++ ){
-				init_orb += molecule.atoms[j].norb;
-			}
-			for( unsigned j=0; j<=atom; j++ ){
-				n_aorbs  += molecule.atoms[j].norb;
-			}
+	unsigned nmo		= molecule.orb_energies.size();
+	
+	//weights of the molecular orbitals from their energy distance to the frontier orbitals
+	vector<double> w_h( nmo, 0.0 );
+	vector<double> w_l( nmo, 0.0 );
+	int mo_count = 0;
+	for( unsigned i=0; i<=homon; i++ ){
+		coefficient = exp(-abs( molecule.orb_energies[i]-molecule.homo_energy ) );
+		if ( coefficient > pre_coef ){ w_h[i] = coefficient; mo_count++; }
+	}
+	m_log->input_message("Number of occupied MO used to calculate condensed to atom descriptors: ");
+	m_log->input_message(mo_count);
+	m_log->input_message("\n");
+	mo_count = 0;
+	for( unsigned i=lumon; i<nmo; i++ ){
+		coefficient = exp(-abs( molecule.orb_energies[i]-molecule.lumo_energy ) );
+		if ( coefficient > pre_coef ){ w_l[i] = coefficient; mo_count++; }
+	}
+	m_log->input_message("Number of  virtual  MO used to calculate condensed to atom descriptors: ");
+	m_log->input_message(mo_count);
+	m_log->input_message("\n");
+	lrds[0] = this->atomic_populations(molecule,w_h,false);
+	lrds[1] = this->atomic_populations(molecule,w_l,false);
+	
+	//------------------------------------------------
+	//calculating the beta molecular orbitals
+	if ( molecule.betad ){
+		mo_count = 0;
+		for( unsigned i=0; i<nmo; i++ ){
+			w_h[i] = 0.0;
+			w_l[i] = 0.0;
 		}
-		//------------------------------------------------
-		
-		//calculating the occupied molecular orbitals
 		for( unsigned i=0; i<=homon; i++ ){
-			coefficient = exp(-abs( molecule.orb_energies[i]-molecule.homo_energy ) );
-			if ( coefficient > pre_coef ){ 
-				mo_count++;
-				for( unsigned mu=init_orb; mu<n_aorbs; mu++){
-					for ( unsigned nu=init_orb; nu<n_aorbs; nu++ ) {
-						value_h +=coefficient*
-								molecule.coeff_MO[ao*i + mu]*
-								molecule.coeff_MO[ao*i + nu]*
-								molecule.m_overlap[nu+(mu*(mu+1))/2];
-					}
-				}
-			}
+			coefficient = exp(-abs(molecule.orb_energies_beta[i]-molecule.homo_energy ) );
+			if ( coefficient > pre_coef ){ w_h[i] = coefficient; mo_count++; }
 		}
-		
-		if ( atom == 0 ){
-			m_log->input_message("Number of occupied MO used to calculate condensed to atom descriptors: ");
-			m_log->input_message(mo_count);
-			m_log->input_message("\n");	
-		}
-		
-		//------------------------------------------------
+		m_log->input_message("Number of occupied beta MO used to calculate condensed to atom descriptors: ");
+		m_log->input_message(mo_count);
+		m_log->input_message("\n");
 		mo_count = 0;
-		//calculating the virtual molecular orbitals
-		for( unsigned i=lumon;i<molecule.orb_energies.size();i++){
-			coefficient = exp(-abs( molecule.orb_energies[i]-molecule.lumo_energy ) );
-			if ( coefficient > pre_coef ){ 
-				mo_count++;
-				for(unsigned mu=init_orb;mu<n_aorbs;mu++){
-					for (unsigned nu=init_orb;nu<n_aorbs;nu++){
-						value_l +=coefficient*
-								molecule.coeff_MO[ao*i + mu]*
-								molecule.coeff_MO[ao*i + nu]*
-								molecule.m_overlap[nu+(mu*(mu+1))/2];
-					}
-				}
-			}
+		for( unsigned i=lumon; i<nmo; i++ ){
+			coefficient = exp(-abs(molecule.orb_energies_beta[i]-molecule.lumo_energy ) );
+			if ( coefficient > pre_coef ){ w_l[i] = coefficient; mo_count++; }
 		}
-		if ( atom == 0 ){
-			m_log->input_message("Number of  virtual  MO used to calculate condensed to atom descriptors: ");
-			m_log->input_message(mo_count);
-			m_log->input_message("\n");	
-		}		
-		
-		//------------------------------------------------
-			
-		//calculating the beta molecular orbitals
-		if ( molecule.betad ){
-			mo_count = 0;
-			for( int i=0;i<=homon;i++){
-				coefficient = exp(-abs(molecule.orb_energies_beta[i]-molecule.homo_energy ) );
-				if ( coefficient > pre_coef ){ 
-					mo_count++;
-					for(int mu=init_orb;mu<n_aorbs;mu++){
-						for (int nu=init_orb;nu<n_aorbs;nu++) {
-							value_h +=coefficient*
-									molecule.coeff_MO_beta[ao*i + mu]*
-									molecule.coeff_MO_beta[ao*i + nu]*
-									molecule.m_overlap[nu+(mu*(mu+1))/2];
-						}
-					}
-				}
-			}
-			value_h /=2;
-			
-			if ( atom == 0 ){
-				m_log->input_message("Number of occupied beta MO used to calculate condensed to atom descriptors: ");
-				m_log->input_message(mo_count);
-				m_log->input_message("\n");
-			}
-			
-			mo_count = 0;
-			for( int i=lumon;i<molecule.orb_energies.size();i++){
-				coefficient = exp(-abs(molecule.orb_energies_beta[i]-molecule.lumo_energy ) );
-				if ( coefficient >  pre_coef  ){ 
-					mo_count++;
-					for(int mu=init_orb;mu<n_aorbs;mu++){
-						for (int nu=init_orb;nu<n_aorbs;nu++) {
-							value_l +=coefficient*
-									molecule.coeff_MO_beta[ao*i + mu]*
-									molecule.coeff_MO_beta[ao*i + nu]*
-									molecule.m_overlap[nu+(mu*(mu+1))/2];
-						}
-					}
-				}
-			}
-			value_l /=2;
-			
-			if ( atom == 0 ){
-				m_log->input_message("Number of  virtual  MO used to calculate condensed to atom descriptors: ");
-				m_log->input_message(mo_count);
-				m_log->input_message("\n");	
-			}
+		m_log->input_message("Number of  virtual  MO used to calculate condensed to atom descriptors: ");
+		m_log->input_message(mo_count);
+		m_log->input_message("\n");
+		vector<double> beta_h = this->atomic_populations(molecule,w_h,true);
+		vector<double> beta_l = this->atomic_populations(molecule,w_l,true);
+		for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
+			lrds[0][atom] = ( lrds[0][atom] + beta_h[atom] )/2;
+			lrds[1][atom] = ( lrds[1][atom] + beta_l[atom] )/2;
 		}
-		lrds[0][atom] = value_h;
-		lrds[1][atom] = value_l;
-		lrds[12][atom]= value_h + value_l;
+	}
+	for( unsigned atom=0; atom<molecule.atoms.size(); atom++ ){
+		lrds[12][atom]	= lrds[0][atom] + lrds[1][atom];
 		lrds[13][atom]	= molecule.atoms[atom].charge;
-		value_h = 0;
-		value_l = 0;
 	}
 	lrds[0] = norm_dvec(lrds[0],3);
 	lrds[1] = norm_dvec(lrds[1],3);
@@ -423,24 +405,23 @@ void local_rd_cnd::energy_weighted_fukui_functions( const Imolecule& molecule ){
 	}
 }
 /***********************************************************************************/
+const cell_list& local_rd_cnd::neighbours(const Imolecule& molecule){
+	double cut = pair_cutoff;
+	if ( molecule.bohr ) cut /= 0.52917726;
+	// the pairs are kept while the coordinates match, copies share them until one sees another geometry
+	if ( !atom_pairs || atom_pairs->cutoff != cut || !atom_pairs->same_coords(molecule) ){
+		std::shared_ptr<cell_list> pairs = std::make_shared<cell_list>( molecule, vector<double>(molecule.atoms.size(),0.0) );
+		pairs->set_neighbours(cut);
+		atom_pairs	= pairs;
+	}
+	return *atom_pairs;
+}
+/***********************************************************************************/
 void local_rd_cnd::calculate_fukui_potential( const Imolecule& molecule ){
-	double r, xi, yi, zi = 0;
-	unsigned nof = molecule.atoms.size();
-	for (unsigned i=0; i<nof; i++ ){
-		for (unsigned j=0; j<nof; j++ ){
-			if ( i != j ){
-				xi = molecule.atoms[i].xcoord - molecule.atoms[j].xcoord;
-				xi *= xi; 
-				yi = molecule.atoms[i].ycoord - molecule.atoms[j].ycoord;
-				yi *= yi;
-				zi = molecule.atoms[i].zcoord - molecule.atoms[j].zcoord;
-				zi *= zi;
-				r  = sqrt(xi+yi+zi);
-				lrds[6][i] += lrds[0][j]/r;
-				lrds[7][i] += lrds[1][j]/r;
-				lrds[8][i] += lrds[2][j]/r;
-			}
-		}
+	const cell_list& pairs = this->neighbours(molecule);
+	for( unsigned k=0; k<3; k++ ){
+		vector<double> pot = pairs.charge_potential(lrds[k]);
+		for( unsigned i=0; i<pot.size(); i++ ) lrds[6+k][i] += pot[i];
 	}
 }
 /***********************************************************************************/
@@ -456,75 +437,80 @@ void local_rd_cnd::calculate_RD(const global_rd& grd){
 /***********************************************************************************/
 void local_rd_cnd::calculate_hardness(const global_rd& grd, const Imolecule& molecule){
 	unsigned nof		= molecule.atoms.size();
-	unsigned init_orb	= 0;
-	unsigned n_aorbs	= 0;
-	double value		= 0.0;
 	double occ 			= 2.0;
 	unsigned ao 		= molecule.num_of_ao; 
+	vector<unsigned> local_off;
+	const vector<unsigned>& aoff = atom_ao_offset(molecule,local_off);
+	if ( molecule.betad ) { occ = 1.0 ;}
 
 	//-----------------------------------------------------
 	//Estimating electron density
-	for( unsigned atom=0; atom<nof; atom++ ){
-		init_orb	= 0;
-		n_aorbs		= 0;
-		if ( atom == 0 ) {
-			init_orb = 0;
-			n_aorbs  = molecule.atoms[0].orbitals.size();
-		}else{
-			for(unsigned j=0; j<atom; j++ ){
-				init_orb += molecule.atoms[j].norb;
-			}
-			for(unsigned j=0; j<=atom; j++ ){
-				n_aorbs  += molecule.atoms[j].norb;
-			}
+	omp_set_num_threads(NP);
+	if ( molecule.sparse_MO() ){
+		//localized MOs: squared sum of the stored coefficients of each atom
+		vector<unsigned> ao_atom(ao);
+		for( unsigned atom=0; atom<nof; atom++ ){
+			for( unsigned mu=aoff[atom]; mu<aoff[atom+1]; mu++ ) ao_atom[mu] = atom;
 		}
-		if ( molecule.betad ) { occ = 1.0 ;}
+		std::fill(lrds[14].begin(),lrds[14].end(),0.0);
+		#pragma omp parallel
+		{
+		vector<double> dens(nof,0.0);
+		vector<double> sum(nof,0.0);
+		#pragma omp for schedule(dynamic,16)
 		for( unsigned i=0; i<=molecule.homoN; i++ ){
-			for(unsigned mu=init_orb; mu<n_aorbs; mu++ ){
-				for (unsigned nu=init_orb; nu<n_aorbs; nu++ ){
-					value+=occ*
-							molecule.coeff_MO[ao*i + mu]*
-							molecule.coeff_MO[ao*i + nu];
-				}
+			for( unsigned k=molecule.lmo_first[i]; k<molecule.lmo_first[i+1]; k++ ) sum[ao_atom[molecule.lmo_ao[k]]] += molecule.lmo_coeff[k];
+			for( unsigned k=molecule.lmo_first[i]; k<molecule.lmo_first[i+1]; k++ ){
+				unsigned atom	= ao_atom[molecule.lmo_ao[k]];
+				dens[atom]		+= occ*sum[atom]*sum[atom];
+				sum[atom]		= 0.0;
 			}
 		}
-		if ( molecule.occupied_beta.size() > 0 ){
+		#pragma omp critical
+		for( unsigned atom=0; atom<nof; atom++ ) lrds[14][atom] += dens[atom];
+		}
+	}
+	else{
+		#pragma omp parallel for schedule(dynamic,16)
+		for( unsigned atom=0; atom<nof; atom++ ){
+			unsigned init_orb	= aoff[atom];
+			unsigned n_aorbs	= aoff[atom+1];
+			double value		= 0.0;
 			for( unsigned i=0; i<=molecule.homoN; i++ ){
-				if ( molecule.occupied_beta[i] > 0 ){
-					for(unsigned mu=init_orb; mu<n_aorbs; mu++ ){
-						for (unsigned nu=init_orb; nu<n_aorbs; nu++ ){
-							value +=molecule.coeff_MO_beta[ao*i + mu]*
-									molecule.coeff_MO_beta[ao*i + nu];
+				for(unsigned mu=init_orb; mu<n_aorbs; mu++ ){
+					for (unsigned nu=init_orb; nu<n_aorbs; nu++ ){
+						value+=occ*
+								molecule.coeff_MO[ao*i + mu]*
+								molecule.coeff_MO[ao*i + nu];
+					}
+				}
+			}
+			if ( molecule.occupied_beta.size() > 0 ){
+				for( unsigned i=0; i<=molecule.homoN; i++ ){
+					if ( molecule.occupied_beta[i] > 0 ){
+						for(unsigned mu=init_orb; mu<n_aorbs; mu++ ){
+							for (unsigned nu=init_orb; nu<n_aorbs; nu++ ){
+								value +=molecule.coeff_MO_beta[ao*i + mu]*
+										molecule.coeff_MO_beta[ao*i + nu];
+							}
 						}
 					}
 				}
 			}
+			lrds[14][atom] = value;
 		}
-		lrds[14][atom] = value;
-		value = 0;
 	}
 	
-	double xi, yi, zi, r = 0.000;
 	//-----------------------------------------------------
 	//calculating local hardness with method (electron-electron interaction)
+	vector<double> pot = this->neighbours(molecule).charge_potential(lrds[14]);
 	for (unsigned i=0; i<nof; i++ ){
-		for (unsigned j=0; j<nof; j++ ){
-			if ( i != j ){
-				xi = molecule.atoms[i].xcoord - molecule.atoms[j].xcoord;
-				xi *= xi; 
-				yi = molecule.atoms[i].ycoord - molecule.atoms[j].ycoord;
-				yi *= yi;
-				zi = molecule.atoms[i].zcoord - molecule.atoms[j].zcoord;
-				zi *= zi;
-				r  = sqrt(xi+yi+zi);
-				lrds[4][i] += lrds[14][j]/r;
-			}
-		}
-		lrds[4][i] /= molecule.num_of_electrons;
+		lrds[4][i] = ( lrds[4][i] + pot[i] )/molecule.num_of_electrons;
 	}
 	
 	//----------------------------------------------------
 	//calculating local hardness with method (LCP)
+	#pragma omp parallel for
 	for(unsigned i=0; i<nof; i++ ){
 		lrds[5][i] = lrds[0][i]*( grd.grds[7] /nof )
 						+ (lrds[14][i]/nof)*grd.grds[8]*2;
@@ -539,6 +525,7 @@ void local_rd_cnd::calculate_hardness(const global_rd& grd, const Imolecule& mol
 		std::vector<double> temp2 = lrds[14];
 		
 		
+		#pragma omp parallel for
 		for ( unsigned i=0; i<nof; i++ ){
 			temp1[i]	= pow(temp1[i],0.6666667);
 			lrds[16][i]	= (10.0/(9.0*molecule.num_of_electrons))*temp1[i];
@@ -550,36 +537,28 @@ void local_rd_cnd::calculate_hardness(const global_rd& grd, const Imolecule& mol
 }
 /*************************************************************************************/
 void local_rd_cnd::calculate_mep(const Imolecule& molecule){
-	double xi, yi, zi, r = 0.000;
-	for( unsigned i=0; i<molecule.atoms.size(); i++ ){
-		for( unsigned j=0; j<molecule.atoms.size(); j++ ){
-			if (i != j){
-				xi = molecule.atoms[i].xcoord - molecule.atoms[j].xcoord;
-				xi *= xi; 
-				yi = molecule.atoms[i].ycoord - molecule.atoms[j].ycoord;
-				yi *= yi;
-				zi = molecule.atoms[i].zcoord - molecule.atoms[j].zcoord;
-				zi *= zi;
-				r  = sqrt(xi+yi+zi);
-				lrds[15][i] += molecule.atoms[j].charge/r;
-			}
-		}
-	}
+	vector<double> charges( molecule.atoms.size() );
+	for( unsigned i=0; i<molecule.atoms.size(); i++ ) charges[i] = molecule.atoms[i].charge;
+	vector<double> pot = this->neighbours(molecule).charge_potential(charges);
+	for( unsigned i=0; i<pot.size(); i++ ) lrds[15][i] += pot[i];
 }
 /*************************************************************************************/
 protein_lrd local_rd_cnd::rd_protein(const Iprotein& prot){
 
 	vector<residue_lrd> res_rd( prot.residues.size() );
 	unsigned nof = lrds[0].size();
-	unsigned cnt = 0;
-	unsigned atom_index = 0;
+	
+	//first atom of each residue, so the residues are summed independently
+	vector<unsigned> first( prot.residues.size()+1, 0 );
+	for( unsigned j=0; j<prot.residues.size(); j++) first[j+1] = first[j] + prot.residues[j].atom_s;
 
-	for( unsigned i=0; i<lrds.size(); i++){
-		atom_index = 0;
-		for( unsigned j=0; j<prot.residues.size(); j++){
-			for( unsigned k=0; k<prot.residues[j].atom_s;k++){
-				res_rd[j].rd_sum[i] += lrds[i][atom_index++];
-			}
+	omp_set_num_threads(NP);
+	#pragma omp parallel for schedule(dynamic,16)
+	for( unsigned j=0; j<prot.residues.size(); j++){
+		for( unsigned i=0; i<lrds.size(); i++){
+			double value = 0.0;
+			for( unsigned k=first[j]; k<first[j+1]; k++) value += lrds[i][k];
+			res_rd[j].rd_sum[i] += value;
 		}
 	}
 
@@ -705,7 +684,10 @@ void local_rd_cnd::write_rd_protein_pdb(const Iprotein& protein){
 	m_log->inp_delim(1);
 	
 	fs::create_directory(name+"_PDB_RD");
-	rd_results.write_models(name+"_PDB_RD");
+	std::shared_ptr<pdb> models = std::make_shared<pdb>( move(rd_results) );
+	string path = name+"_PDB_RD";
+	std::size_t bytes = models->models.size()*prot.xcoord.size()*80;
+	out_writer.submit( [models,path]{ models->write_models(path); }, bytes );
 }
 /*************************************************************************************/
 void local_rd_cnd::write_LRD(const Imolecule& mol){
@@ -715,10 +697,7 @@ void local_rd_cnd::write_LRD(const Imolecule& mol){
 	}else{
 		temps = name+"FOA.lrd";
 	}
-	const char* Name_s = temps.c_str();
-	std::ofstream lrd_file;
-	lrd_file.open(Name_s);
-	
+	std::ostringstream lrd_file;
 	lrd_file.precision(6);
 	lrd_file << std::fixed;
 	lrd_file << name << " " << "\n" <<  std::left; 
@@ -740,7 +719,7 @@ void local_rd_cnd::write_LRD(const Imolecule& mol){
 		}
 		lrd_file << endl;
 	}
-	lrd_file.close();
+	out_writer.submit_text(lrd_file.str(),temps);
 	m_log->input_message("Finishing the writting of the condensed local reactivity descriptors.\n");
 	m_log->inp_delim(2);
 }
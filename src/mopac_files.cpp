@@ -23,6 +23,7 @@
 #include <cmath>
 #include <omp.h>
 #include <algorithm>  
+#include <charconv>
 
 //Including PRIMoRDiA headers
 //-------------------------------------------------------
@@ -33,6 +34,7 @@
 #include "../include/Imolecule.h"
 #include "../include/Iline.h"
 #include "../include/Ibuffer.h"
+#include "../include/Imapped_file.h"
 #include "../include/mopac_files.h"
 //-------------------------------------------------------
 #include <Eigen/Eigenvalues>
@@ -76,6 +78,19 @@ string _ao_pqn  = "ATOM_PQN[";					//19
 string _atom_chg = "ATOM_CHARGES[";				//10
 
 vector<string> _states = {"SINGLET", "DOUBLET", "TRIPLET", "QUARTET","QUINTET"};
+
+const double lmo_tol = 1.0e-6; // localized MO coefficients up to this magnitude are not stored
+//================================================================================
+// read the next number of the line as the stream extraction does, false at the first
+// character that does not start a number.
+static inline bool read_number(const char*& it, const char* fin, double& val){
+	it = skip_blanks(it,fin);
+	if ( it < fin && *it == '+' ) ++it;
+	auto res = std::from_chars(it,fin,val);
+	if ( res.ec != std::errc() ) return false;
+	it = res.ptr;
+	return true;
+}
 /**************************************/
 
 //======================================================================
@@ -85,13 +100,15 @@ mopac_files::mopac_files()		:
 	f_chg(0)					,
 	name_f("no_name")			,
 	is_open(false)				,
-	type("no_type")				{
+	type("no_type")				,
+	mo_band(-1)					{
 }
 /***************************************************************************************/
 mopac_files::mopac_files(const char* file_name):
 	LMO(false)									,
 	is_open(false)								,
-	RHF(true)									{
+	RHF(true)									,
+	mo_band(-1)									{
 	
 	name_f = file_name;
 	molecule.name = get_file_name(file_name);
@@ -163,7 +180,7 @@ mopac_files::mopac_files(const char* file_name):
 				else if ( Buffer_o.lines[i].IF_word(_states[2],1,7) ) RHF =false; 
 				else if ( Buffer_o.lines[i].IF_word(_states[3],1,7) ) RHF =false; 
 				else if ( Buffer_o.lines[i].IF_word(_states[4],1,7) ) RHF =false; 
-				else if ( Buffer_o.lines[i].IF_word(_chg,1,6) )	f_chg = stoi(Buffer_o.lines[i].words[5]); 
+				else if ( Buffer_o.lines[i].IF_word(_chg,1,6) )	f_chg = Buffer_o.lines[i].get_int(5); 
 			}
 		}else if (check_file_ext(".mgf",file_name) ){
 			type = "MGF";
@@ -219,7 +236,7 @@ void mopac_files::parse_aux(){
 	for( unsigned int i=_in[0]; i<_out[0]; i++ ){
 		for ( unsigned j=0; j<Buffer.lines[i].words.size(); j++ ){
 				Iatom atom;
-				atom.set_type( Buffer.lines[i].words[j] );
+				atom.set_type( Buffer.lines[i].get_string(j) );
 				molecule.add_atom(atom);
 		}
 	}
@@ -299,11 +316,12 @@ void mopac_files::parse_aux(){
 	molecule.get_ao_number();
 	
 	this->get_overlap_m();
-	this->get_mo(false);
+	// the energies come first to choose the MO coefficients to load
 	this->get_mo_energies(false);
+	this->get_mo(false);
 	if ( !RHF ) {
-		this->get_mo(true);
 		this->get_mo_energies(true);
+		this->get_mo(true);
 	}	
 	
 	counter = 0;
@@ -709,13 +727,13 @@ void mopac_files::get_overlap_m(){
 	int nLines 			= 0;
 	double temp			= 0.0;
 	
-	char tmp_line[500];
-	
 	if ( IF_file(name_f) ){
-		std::ifstream buf(name_f);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
-			Iline Line(tmp_line);
+		Imapped_file buf(name_f);
+		const char* it	= buf.begin();
+		const char* fin	= buf.end();
+		while( it < fin ){
+			const char* eol = next_line(it,fin);
+			Iline Line(it,eol);
 			if ( nLines == 205 ){
 				int o = 0;
 			}
@@ -724,14 +742,13 @@ void mopac_files::get_overlap_m(){
 					in_indx		= nLines;
 				}
 			}else if ( in_indx >0 && molecule.m_overlap.size() < fin_indx) {
-				std::stringstream ssline(tmp_line);
-				while ( ssline >> temp ){
+				while ( read_number(it,eol,temp) ){
 					molecule.m_overlap.push_back(temp);
 				}
 			}
 			nLines++;
+			it = eol;
 		}
-		buf.close();
 		m_log->input_message("Size of Overlap matrix: \n\t");
 		m_log->input_message( int( molecule.m_overlap.size() ) );
 	}else{
@@ -754,35 +771,61 @@ void mopac_files::get_mo(bool beta){
 	int nHomo			= molecule.num_of_electrons/2 - 1;
 	int nLumo			= nHomo+1;
 	unsigned int nMO_out= nAO*nAO;
+	// the localized MOs have no energy ordering, all of them are read
+	if ( !LMO ){
+		const std::vector<double>& energies = beta ? molecule.orb_energies_beta : molecule.orb_energies;
+		nMO_out = nAO*molecule.MO_window(energies,mo_band,1.0);
+	}
 	int in_indx			= -1;
 	int fin_indx		= nAO*nAO/10;
 	std::vector<double> mo_c;
+	// the localized MOs of MOZYME runs are mostly zeros, only the larger coefficients are kept
+	bool sparse			= LMO && RHF && !beta;
+	if ( sparse ){
+		molecule.lmo_first.assign(1,0);
+		molecule.lmo_ao.clear();
+		molecule.lmo_coeff.clear();
+	}
 
-	char tmp_line[500];
 	string tmpt;
 	
 	if ( IF_file(name_f) ){
-		std::ifstream buf(name_f);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
-			Iline Line(tmp_line);
+		Imapped_file buf(name_f);
+		const char* it	= buf.begin();
+		const char* fin	= buf.end();
+		while( it < fin ){
+			const char* eol = next_line(it,fin);
+			Iline Line(it,eol);
 			if ( in_indx == -1 ){
 				if ( Line.IF_word( keyword,0,keyword.size() ) ){
 					in_indx = nLines;
 				}
 			}else if ( in_indx > 0 && nMO < nMO_out){
-				std::stringstream ssline(tmp_line);
-				while ( ssline >> temp ){
-					mo_c.push_back(temp);
+				while ( read_number(it,eol,temp) ){
+					if ( sparse ){
+						if ( std::abs(temp) > lmo_tol ){
+							molecule.lmo_ao.push_back(nMO%nAO);
+							molecule.lmo_coeff.push_back(temp);
+						}
+						if ( (nMO+1)%nAO == 0 ) molecule.lmo_first.push_back( molecule.lmo_ao.size() );
+					}
+					else mo_c.push_back(temp);
 					nMO++;
 				}
 			}else{
 				break;
 			}
 			nLines++;
+			it = eol;
 		}
-		buf.close();
-		if ( !beta ) {
+		if ( mo_c.size() > nMO_out ) mo_c.resize(nMO_out);
+		if ( sparse ){
+			m_log->input_message("Number of localized MO vectors: \n\t");
+			m_log->input_message( int( molecule.lmo_first.size()-1 ) );
+			m_log->input_message("Number of stored localized MO coefficients: \n\t");
+			m_log->input_message( int( molecule.lmo_coeff.size() ) );
+		}
+		else if ( !beta ) {
 			copy( mo_c.begin(),mo_c.end(),back_inserter(molecule.coeff_MO) );
 			m_log->input_message("Number of MO vectors: \n\t");
 			m_log->input_message( int( molecule.coeff_MO.size() ) );
@@ -816,14 +859,15 @@ void mopac_files::get_mo_energies(bool beta){
 	int fin_indx			= nAO/10;
 	std::vector<double> mo_c;
 	
-	char tmp_line[500];
 	string tmpt;
 	
 	if ( IF_file(name_f) ){
-		std::ifstream buf(name_f);
-		while( !buf.eof() ){
-			buf.getline(tmp_line,500);
-			Iline Line(tmp_line);
+		Imapped_file buf(name_f);
+		const char* it	= buf.begin();
+		const char* fin	= buf.end();
+		while( it < fin ){
+			const char* eol = next_line(it,fin);
+			Iline Line(it,eol);
 			if ( in_indx == -1 ){
 				if ( Line.IF_word( keyword,0,keyword.size() ) ) {
 					in_indx = nLines;
@@ -835,15 +879,14 @@ void mopac_files::get_mo_energies(bool beta){
 					}
 				}
 			}else if ( in_indx > 0 && mo_c.size() < nAO ){
-				std::stringstream ssline(tmp_line);
-				while ( ssline >> temp ){
+				while ( read_number(it,eol,temp) ){
 					mo_c.push_back(temp);
 				}
 				nMO++;
 			}
 			nLines++;
+			it = eol;
 		}
-		buf.close();
 		if ( !beta ) {
 			copy( mo_c.begin(),mo_c.end(),back_inserter(molecule.orb_energies) );
 			molecule.MOnmb = molecule.orb_energies.size();
@@ -0,0 +1,167 @@
+// orb_kernels.cpp
+// source file for the vectorized radial kernels of the atomic orbitals on the grid
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+//including c++ headers
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+//including PRIMoRDiA headers
+#include "../include/orb_kernels.h"
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define ORB_KERNELS_DISPATCH
+#endif
+
+#define KERNEL_INLINE inline __attribute__((always_inline))
+
+/***********************************************************************/
+// exp(x) for x <= 0 by range reduction x = k*ln2 + r, |r| <= ln2/2, and a degree 12
+// Taylor polynomial of exp(r), relative error below 1e-15. Branch free to be vectorized.
+static KERNEL_INLINE double exp_neg(double x){
+	const double log2e	= 1.4426950408889634;
+	const double ln2_hi	= 6.93147180369123816490e-01;
+	const double ln2_lo	= 1.90821492927058770002e-10;
+	const double magic	= 6755399441055744.0; // 1.5*2^52, rounds to integer in the low mantissa bits
+	x = x > -708.0 ? x : -708.0;
+#if FLT_EVAL_METHOD == 0
+	double kd	= x*log2e + magic;
+	double k	= kd - magic;
+#else
+	// the x87 registers keep kd in extended precision and kd - magic is not an integer,
+	// k is rounded explicitly and kd is exact from it
+	double k	= std::nearbyint(x*log2e);
+	double kd	= k + magic;
+#endif
+	double r	= x - k*ln2_hi - k*ln2_lo;
+	double p	= 1.0/479001600.0;
+	p = p*r + 1.0/39916800.0;
+	p = p*r + 1.0/3628800.0;
+	p = p*r + 1.0/362880.0;
+	p = p*r + 1.0/40320.0;
+	p = p*r + 1.0/5040.0;
+	p = p*r + 1.0/720.0;
+	p = p*r + 1.0/120.0;
+	p = p*r + 1.0/24.0;
+	p = p*r + 1.0/6.0;
+	p = p*r + 0.5;
+	p = p*r + 1.0;
+	p = p*r + 1.0;
+	// scaling by 2^k adding k to the exponent bits
+	int64_t ki, pi;
+	std::memcpy(&ki,&kd,sizeof(double));
+	std::memcpy(&pi,&p,sizeof(double));
+	pi += int64_t( uint64_t( ki - int64_t(0x4338000000000000) ) << 52 );
+	std::memcpy(&p,&pi,sizeof(double));
+	return p;
+}
+/***********************************************************************/
+static KERNEL_INLINE void gauss_line_impl(unsigned int n, const double* d, double expo, double scale, double* out){
+	#pragma omp simd
+	for( unsigned int i=0; i<n; i++ ){
+		out[i] = scale*exp_neg( -expo*d[i]*d[i] );
+	}
+}
+/***********************************************************************/
+static KERNEL_INLINE void slater_line_impl(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out){
+	#pragma omp simd
+	for( unsigned int i=0; i<n; i++ ){
+		out[i] = exp_neg( -alpha*sqrt( rxy2 + z[i]*z[i] ) );
+	}
+	// the power of r is applied in separate passes to keep the loops free of inner branches
+	for( int k=0; k<nr; k++ ){
+		#pragma omp simd
+		for( unsigned int i=0; i<n; i++ ) out[i] *= sqrt( rxy2 + z[i]*z[i] );
+	}
+}
+/***********************************************************************/
+typedef void (*gauss_line_fn)(unsigned int, const double*, double, double, double*);
+typedef void (*slater_line_fn)(unsigned int, double, const double*, double, int, double*);
+
+static void gauss_line_base(unsigned int n, const double* d, double expo, double scale, double* out){
+	gauss_line_impl(n,d,expo,scale,out);
+}
+static void slater_line_base(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out){
+	slater_line_impl(n,rxy2,z,alpha,nr,out);
+}
+#ifdef ORB_KERNELS_DISPATCH
+__attribute__((target("avx2,fma")))
+static void gauss_line_avx2(unsigned int n, const double* d, double expo, double scale, double* out){
+	gauss_line_impl(n,d,expo,scale,out);
+}
+__attribute__((target("avx2,fma")))
+static void slater_line_avx2(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out){
+	slater_line_impl(n,rxy2,z,alpha,nr,out);
+}
+__attribute__((target("avx512f")))
+static void gauss_line_avx512(unsigned int n, const double* d, double expo, double scale, double* out){
+	gauss_line_impl(n,d,expo,scale,out);
+}
+__attribute__((target("avx512f")))
+static void slater_line_avx512(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out){
+	slater_line_impl(n,rxy2,z,alpha,nr,out);
+}
+#endif
+/***********************************************************************/
+// instruction set level available in the running processor, 2 for AVX-512, 1 for AVX2
+static int isa_level(){
+#ifdef ORB_KERNELS_DISPATCH
+	__builtin_cpu_init();
+	if ( __builtin_cpu_supports("avx512f") ) return 2;
+	if ( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ) return 1;
+#endif
+	return 0;
+}
+static const int kernel_level = isa_level();
+#ifdef ORB_KERNELS_DISPATCH
+static const gauss_line_fn	gauss_line_ptr	= kernel_level == 2 ? gauss_line_avx512	: ( kernel_level == 1 ? gauss_line_avx2	: gauss_line_base );
+static const slater_line_fn	slater_line_ptr	= kernel_level == 2 ? slater_line_avx512 : ( kernel_level == 1 ? slater_line_avx2 : slater_line_base );
+#else
+static const gauss_line_fn	gauss_line_ptr	= gauss_line_base;
+static const slater_line_fn	slater_line_ptr	= slater_line_base;
+#endif
+/***********************************************************************/
+void gauss_line(unsigned int n, const double* d, double expo, double scale, double* out){
+	gauss_line_ptr(n,d,expo,scale,out);
+}
+/***********************************************************************/
+void slater_line(unsigned int n, double rxy2, const double* z, double alpha, int nr, double* out){
+	slater_line_ptr(n,rxy2,z,alpha,nr,out);
+}
+/***********************************************************************/
+// one exponential at a time, kept out of line so the check runs the scalar code.
+static __attribute__((noinline)) double exp_neg_scalar(double x){ return exp_neg(x); }
+/***********************************************************************/
+double orb_kernels_error(){
+	double err = 0.0;
+	for( int i=0; i<=7000; i++ ){
+		double x	= -0.1*i - 0.0137*(i%7);
+		double ref	= std::exp(x);
+		err = std::max( err, std::abs( exp_neg_scalar(x) - ref )/ref );
+	}
+	return err;
+}
+/***********************************************************************/
+const char* orb_kernels_isa(){
+	if		( kernel_level == 2 ) return "AVX-512";
+	else if	( kernel_level == 1 ) return "AVX2";
+	return "baseline";
+}
+//================================================================================
+//END OF FILE
+//================================================================================
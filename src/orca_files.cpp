@@ -46,11 +46,13 @@ using std::cout;
 //=======================================================
 orca_files::orca_files()		:
 	name_f("none")				,
-	is_open(false)				{
+	is_open(false)				,
+	mo_band(-1)					{
 }
 /**********************************************************************************/
 orca_files::orca_files(const char* file_name)	:
-	is_open( false )							{
+	is_open( false )							,
+	mo_band(-1)									{
 	
 	if ( IF_file(file_name) ){
 		is_open = true;
@@ -216,9 +218,34 @@ void orca_files::parse_out(){
 	line_indicator = 0;
 	bool bet = false;
 	
-	molecule.coeff_MO.resize(aonum*aonum);
+	// the atomic charges give the LUMO of the MO window, they are read before the MOs
+	int counter = 0;
+	int ls = 0; //line number of words 
+	Ibuffer Buffer3(name_f,chg_in,chg_fin);
+	for( unsigned i=0; i<Buffer3.nLines; i++ ){
+		if  ( molecule.atoms[counter].element.size() > 1 ){
+			ls = 3;
+		}else {
+			ls = 4;
+		}
+		if ( !molecule.betad ) {
+			if ( Buffer3.lines[i].line_len == ls && counter < molecule.num_of_atoms ) {
+				molecule.atoms[counter++].charge = Buffer3.lines[i].get_double(ls-1);
+			}
+		}else{
+			ls++;
+			if ( Buffer3.lines[i].line_len == ls && counter < molecule.num_of_atoms ) {
+				molecule.atoms[counter++].charge = Buffer3.lines[i].get_double(ls-2);
+			}
+		}
+	}
+	
+	// only the MO columns of the window are kept
+	unsigned nkeep	= molecule.MO_window(molecule.orb_energies,mo_band,1.0);
+	unsigned nkeep_b= molecule.MO_window(molecule.orb_energies_beta,mo_band,1.0);
+	molecule.coeff_MO.resize(aonum*nkeep);
 	if ( molecule.betad ) { 
-		molecule.coeff_MO_beta.resize(aonum*aonum);
+		molecule.coeff_MO_beta.resize(aonum*nkeep_b);
 	}
 	
 	Buffer.clear();
@@ -235,7 +262,7 @@ void orca_files::parse_out(){
 		else if ( Buffer2.lines[j].line_len > 0 && line_indicator == 3  ) { line_indicator++; }
 		else if ( Buffer2.lines[j].line_len >=3 && line_indicator == 4 && bet ){
 			for( l=0; l<Buffer2.lines[j].line_len-2; l++ ){ 
-				molecule.coeff_MO_beta[(col_n+l)*aonum+row_n] = Buffer2.lines[j].pop_double(2);
+				if ( col_n+l < nkeep_b ) molecule.coeff_MO_beta[(col_n+l)*aonum+row_n] = Buffer2.lines[j].pop_double(2);
 			}
 			row_n++;
 			if ( row_n == aonum ) line_indicator = 0;
@@ -245,7 +272,7 @@ void orca_files::parse_out(){
 		}
 		else if ( Buffer2.lines[j].line_len >= 3 && line_indicator == 4 ) {
 			for( l=0; l<Buffer2.lines[j].line_len-2; l++ ){ 
-				molecule.coeff_MO[(col_n+l)*aonum+row_n] = Buffer2.lines[j].pop_double(2);
+				if ( col_n+l < nkeep ) molecule.coeff_MO[(col_n+l)*aonum+row_n] = Buffer2.lines[j].pop_double(2);
 			}
 			row_n++;
 			if ( row_n == aonum ) {
@@ -259,27 +286,7 @@ void orca_files::parse_out(){
 		}
 	}
 	
-	int counter = 0;
-	int ls = 0; //line number of words 
 	Buffer2.clear();
-	Ibuffer Buffer3(name_f,chg_in,chg_fin);
-	for( unsigned i=0; i<Buffer3.nLines; i++ ){
-		if  ( molecule.atoms[counter].element.size() > 1 ){
-			ls = 3;
-		}else {
-			ls = 4;
-		}
-		if ( !molecule.betad ) {
-			if ( Buffer3.lines[i].line_len == ls && counter < molecule.num_of_atoms ) {
-				molecule.atoms[counter++].charge = Buffer3.lines[i].get_double(ls-1);
-			}
-		}else{
-			ls++;
-			if ( Buffer3.lines[i].line_len == ls && counter < molecule.num_of_atoms ) {
-				molecule.atoms[counter++].charge = Buffer3.lines[i].get_double(ls-2);
-			}
-		}
-	}
 
 		
 	for ( unsigned i=0; i<molecule.num_of_atoms; i++ ){
@@ -0,0 +1,111 @@
+//output_writer.cpp
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+//------------------------------------------
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory>
+//------------------------------------------
+#include "../include/Icube.h"
+#include "../include/output_writer.h"
+//------------------------------------------
+using std::string;
+using std::move;
+
+// two threads keep the disk busy without taking many cores from the calculations, and the
+// cap keeps the pending copies of the grids within the address space of 32 bits builds
+output_writer out_writer(2,std::size_t(512)<<20);
+
+/*==============================================*/
+output_writer::output_writer(unsigned int nthr, std::size_t cap)	:
+	nthreads(nthr)													,
+	mem_cap(cap)													,
+	pending(0)														,
+	running(0)														,
+	stop(false)														{
+}
+/******************************************************************/
+void output_writer::submit(std::function<void()> job, std::size_t bytes){
+	if ( nthreads == 0 ){
+		job();
+		return;
+	}
+	std::unique_lock<std::mutex> lock(mtx);
+	if ( workers.empty() ){
+		stop = false;
+		for( unsigned int i=0; i<nthreads; i++ ) workers.emplace_back(&output_writer::work,this);
+	}
+	// a job larger than the cap is accepted when nothing else is pending
+	cv_done.wait( lock, [&]{ return pending == 0 || pending + bytes <= mem_cap; } );
+	pending += bytes;
+	jobs.emplace_back( move(job), bytes );
+	lock.unlock();
+	cv_jobs.notify_one();
+}
+/******************************************************************/
+void output_writer::submit_cube(const Icube& cube, const string& file_name){
+	std::shared_ptr<Icube> copy = std::make_shared<Icube>(cube);
+	// the writer threads run beside the calculations, so they format the voxels serially
+	this->submit( [copy,file_name]{ copy->write_cube(file_name,1); }, cube.scalar.size()*sizeof(double) );
+}
+/******************************************************************/
+void output_writer::submit_text(string text, const string& file_name){
+	std::size_t bytes = text.size();
+	std::shared_ptr<string> txt = std::make_shared<string>( move(text) );
+	this->submit( [txt,file_name]{
+		std::ofstream file( file_name.c_str() );
+		file.write( txt->data(), txt->size() );
+	}, bytes );
+}
+/******************************************************************/
+void output_writer::work(){
+	std::unique_lock<std::mutex> lock(mtx);
+	while( true ){
+		cv_jobs.wait( lock, [&]{ return stop || !jobs.empty(); } );
+		if ( jobs.empty() ) return;
+		std::function<void()> job	= move( jobs.front().first );
+		std::size_t bytes			= jobs.front().second;
+		jobs.pop_front();
+		running++;
+		lock.unlock();
+		job();
+		job = nullptr; // releases the data copy before the memory is given back
+		lock.lock();
+		running--;
+		pending -= bytes;
+		cv_done.notify_all();
+	}
+}
+/******************************************************************/
+void output_writer::wait(){
+	std::unique_lock<std::mutex> lock(mtx);
+	cv_done.wait( lock, [&]{ return jobs.empty() && running == 0; } );
+}
+/******************************************************************/
+void output_writer::finish(){
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	cv_jobs.notify_all();
+	for( unsigned int i=0; i<workers.size(); i++ ) workers[i].join();
+	workers.clear();
+}
+/******************************************************************/
+output_writer::~output_writer(){ this->finish(); }
+//================================================================================
+//END OF FILE
+//================================================================================
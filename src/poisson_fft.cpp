@@ -0,0 +1,184 @@
+// poisson_fft.cpp
+// source file for the poisson_fft class
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*********************************************************************/
+//including c++ headers
+#include <iostream>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <omp.h>
+#include <unsupported/Eigen/FFT>
+//including PRIMoRDiA headers
+#include "../include/common.h"
+#include "../include/Icube.h"
+#include "../include/poisson_fft.h"
+
+using std::vector;
+using std::complex;
+
+typedef complex<double> cplx;
+
+// average of 1/r over a cubic voxel of unit side centered at the origin
+const double self_voxel_factor = 2.3800772;
+
+/***********************************************************************/
+// smallest size not lower than n with only 2, 3 and 5 prime factors,
+// which are the radices with specialized butterflies in the FFT backend
+unsigned int fft_size(unsigned int n){
+	while( true ){
+		unsigned int m = n;
+		while ( m%2 == 0 ) m /= 2;
+		while ( m%3 == 0 ) m /= 3;
+		while ( m%5 == 0 ) m /= 5;
+		if ( m == 1 ) return n;
+		n++;
+	}
+}
+/***********************************************************************/
+poisson_fft::poisson_fft()	:
+	volume(0.0)				{
+
+	for( int i=0; i<3; i++ ){
+		grid[i]		= 0;
+		pad[i]		= 0;
+		gridsides[i]= 0.0;
+	}
+}
+/***********************************************************************/
+poisson_fft::poisson_fft(const Icube& grid_ref)	:
+	volume(0.0)									{
+
+	for( int i=0; i<3; i++ ){
+		grid[i]		= grid_ref.grid[i];
+		gridsides[i]= std::abs(grid_ref.gridsides[i]);
+		pad[i]		= fft_size(2*grid[i]-1);
+	}
+	volume = gridsides[0]*gridsides[1]*gridsides[2];
+
+	unsigned int n0 = pad[0];
+	unsigned int n1 = pad[1];
+	unsigned int n2 = pad[2];
+	vector<cplx> kernel(n0*n1*n2);
+	double self_term = self_voxel_factor/std::cbrt(volume);
+	unsigned int i,j,k;
+
+	omp_set_num_threads(NP);
+	#pragma omp parallel for collapse(3) default(shared) private(i,j,k)
+	for( i=0; i<n0; i++ ){
+		for( j=0; j<n1; j++ ){
+			for( k=0; k<n2; k++ ){
+				// wrapped offsets, the padding keeps the convolution free of aliasing
+				double xx = ( i <= n0/2 ? double(i) : double(i) - n0 )*gridsides[0];
+				double yy = ( j <= n1/2 ? double(j) : double(j) - n1 )*gridsides[1];
+				double zz = ( k <= n2/2 ? double(k) : double(k) - n2 )*gridsides[2];
+				double r  = sqrt(xx*xx + yy*yy + zz*zz);
+				if ( i == 0 && j == 0 && k == 0 ) kernel[0] = self_term;
+				else kernel[(i*n1+j)*n2+k] = 1.0/r;
+			}
+		}
+	}
+	// the kernel fills the whole padded grid, all lines are transformed
+	this->transform_axis(kernel,2,n0,n1,false);
+	this->transform_axis(kernel,1,n0,n2,false);
+	this->transform_axis(kernel,0,n1,n2,false);
+	kernel_ft.resize( kernel.size() );
+	for( unsigned int x=0; x<kernel.size(); x++ ) kernel_ft[x] = kernel[x].real();
+}
+/***********************************************************************/
+void poisson_fft::transform_axis(vector<cplx>& data	,
+								int axis			,
+								unsigned int lim_a	,
+								unsigned int lim_b	,
+								bool inverse)		{
+
+	unsigned int n1		= pad[1];
+	unsigned int n2		= pad[2];
+	unsigned int len	= pad[axis];
+	unsigned int stride	= 1;
+	if		( axis == 0 ) stride = n1*n2;
+	else if	( axis == 1 ) stride = n2;
+	unsigned int a,b;
+
+	omp_set_num_threads(NP);
+	#pragma omp parallel default(shared) private(a,b)
+	{
+		Eigen::FFT<double> fft;
+		vector<cplx> line_in(len);
+		vector<cplx> line_out(len);
+		#pragma omp for collapse(2)
+		for( a=0; a<lim_a; a++ ){
+			for( b=0; b<lim_b; b++ ){
+				// lines are indexed by the two coordinates not transformed
+				unsigned int first = 0;
+				if		( axis == 0 ) first = a*n2 + b;
+				else if	( axis == 1 ) first = a*n1*n2 + b;
+				else 				  first = (a*n1 + b)*n2;
+				for( unsigned int l=0; l<len; l++ ) line_in[l] = data[first + l*stride];
+				if ( inverse )	fft.inv(line_out,line_in);
+				else			fft.fwd(line_out,line_in);
+				for( unsigned int l=0; l<len; l++ ) data[first + l*stride] = line_out[l];
+			}
+		}
+	}
+}
+/***********************************************************************/
+void poisson_fft::transform(vector<cplx>& data, bool inverse){
+	// only the lines crossing the non-padded block carry data before the forward
+	// transform, and only that block is needed after the inverse one
+	if ( !inverse ){
+		this->transform_axis(data,2,grid[0],grid[1],false);
+		this->transform_axis(data,1,grid[0],pad[2],false);
+		this->transform_axis(data,0,pad[1],pad[2],false);
+	}else{
+		this->transform_axis(data,0,pad[1],pad[2],true);
+		this->transform_axis(data,1,grid[0],pad[2],true);
+		this->transform_axis(data,2,grid[0],grid[1],true);
+	}
+}
+/***********************************************************************/
+Icube poisson_fft::potential(const Icube& dens){
+	unsigned int n1 = pad[1];
+	unsigned int n2 = pad[2];
+	unsigned int i,j,k;
+	vector<cplx> field(pad[0]*n1*n2);
+
+	for( i=0; i<grid[0]; i++ ){
+		for( j=0; j<grid[1]; j++ ){
+			for( k=0; k<grid[2]; k++ ){
+				field[(i*n1+j)*n2+k] = dens.scalar[(i*grid[1]+j)*grid[2]+k];
+			}
+		}
+	}
+	this->transform(field,false);
+	for( unsigned int x=0; x<field.size(); x++ ) field[x] *= kernel_ft[x];
+	this->transform(field,true);
+
+	Icube result(dens);
+	for( i=0; i<grid[0]; i++ ){
+		for( j=0; j<grid[1]; j++ ){
+			for( k=0; k<grid[2]; k++ ){
+				result.scalar[(i*grid[1]+j)*grid[2]+k] = field[(i*n1+j)*n2+k].real()*volume;
+			}
+		}
+	}
+	return result;
+}
+/***********************************************************************/
+poisson_fft::~poisson_fft(){}
+//================================================================================
+//END OF FILE
+//================================================================================
@@ -184,14 +184,14 @@ void traj_rd::init_from_folder(){
 					residue_lrd residue;
 					Iline line_obj(Line);
 					if ( line_obj.words[0].size() == 1 ){
-						string lbl = line_obj.words[0];
+						string lbl = line_obj.get_string(0);
 						lbl +=  line_obj.words[1];
 						Frame.labels.push_back(lbl);
 						for( int j=2; j<line_obj.line_len; j++ ){
 							residue.rd_sum[j-2] = line_obj.get_double(j);
 						}
 					}else{
-						Frame.labels.push_back(line_obj.words[0]);
+						Frame.labels.push_back( line_obj.get_string(0) );
 						for( int j=1; j<line_obj.line_len; j++ ){
 							residue.rd_sum[j-1] = line_obj.get_double(j);
 						}
@@ -100,6 +100,13 @@ primordia operator-(const primordia& pr_lhs, const primordia& pr_rhs){
 	return Result;
 }
 /*************************************************************************************/
+// volumetric descriptors to calculate for the lrds option, used to skip the unneeded grids
+static std::vector<bool> lrd_needed(){
+	local_rd plan;
+	plan.set_requests();
+	return plan.needed;
+}
+/*************************************************************************************/
 void primordia::init_FOA(const char* file_neutro,
 						int grdN				,
 						string loc_hard			,
@@ -122,7 +129,7 @@ void primordia::init_FOA(const char* file_neutro,
 	
 	//-----------------------------
 	//loading molecular information
-	QMparser qmfile(file_neutro,Program); 
+	QMparser qmfile(file_neutro,Program,0); 
 	Imolecule molecule( move ( qmfile.get_molecule() ) ); 
 	if ( molecule.name == "empty"){
 		m_log->write_warning("Molecular information not used for calculations! Entry "+name);
@@ -155,24 +162,32 @@ void primordia::init_FOA(const char* file_neutro,
 			ch_rd.write_comp_hardness( name.c_str() );
 		}
 		// calculating volumetric local descriptors if required
-		if ( grdN  > 0 ){ 
+		std::vector<bool> needed = lrd_needed();
+		bool orbs	= needed[0] || needed[1] || needed[5] || needed[6];
+		bool dens	= needed[2] && ( loc_hard == "true" || loc_hard == "TFD" );
+		if ( grdN  > 0 && ( orbs || dens ) ){ 
 			gridgen grid1( grdN, move(molecule) );
-			Icube homo_cub	= grid1.calc_HOMO();
-			Icube lumo_cub	= grid1.calc_LUMO();
+			Icube homo_cub;
+			Icube lumo_cub;
+			if ( orbs ){
+				homo_cub	= grid1.calc_HOMO();
+				lumo_cub	= grid1.calc_LUMO();
+			}
 			Icube e_density;
-			if ( loc_hard == "true" || loc_hard == "TFD" ) {
+			if ( dens ) {
 				if ( Program == "orca" ) { grid1.calculate_density_orca(); }
 				else{ grid1.calculate_density(); }
-				e_density = grid1.density;
+				e_density = move(grid1.density);
 			}
 			local_rd lrdVol_1( e_density,homo_cub, lumo_cub );
-			if ( loc_hard == "true" || loc_hard == "TFD"  ){
+			lrdVol_1.name = grid1.name;
+			lrdVol_1.calculate_RD(grd);
+			if ( dens ){
 				if ( loc_hard == "TFD" ){ lrdVol_1.TFD = true; }
 				lrdVol_1.calculate_hardness(grd);
 				lrdVol_1.calculate_MEP(grid1.molecule);
 			}
 			lrdVol_1.calculate_Fukui_potential();
-			lrdVol_1.calculate_RD(grd);
 			lrdVol_1.write_LRD();
 			lrdVol = lrdVol_1;
 			if ( pymol_script ) {
@@ -207,11 +222,11 @@ void primordia::init_FD(const char* file_neutro	,
 	m_log->input_message("\n");
 	//----------------------------------------------------------------------
 	
-	QMparser qmfile1 (file_neutro,Program);
+	QMparser qmfile1 (file_neutro,Program,0);
 	Imolecule molecule_a ( move(qmfile1.get_molecule() ) );
-	QMparser qmfile2 (file_cation,Program);
+	QMparser qmfile2 (file_cation,Program,0);
 	Imolecule molecule_b ( move(qmfile2.get_molecule() ) );
-	QMparser qmfile3 (file_anion,Program);
+	QMparser qmfile3 (file_anion,Program,0);
 	Imolecule molecule_c ( move(qmfile3.get_molecule() ) );
 
 	if ( molecule_a.name == "empty"){
@@ -252,24 +267,39 @@ void primordia::init_FD(const char* file_neutro	,
 			ch_rd = comp_hard(grd,lrdCnd,molecule_a,den);
 			ch_rd.write_comp_hardness( name.c_str() );
 		}
-		if ( grdN > 0 ){
+		std::vector<bool> needed = lrd_needed();
+		bool fukui = needed[5] || needed[6];
+		if ( grdN > 0 && ( needed[2] || needed[3] || needed[4] || fukui ) ){
 			gridgen grid1 ( grdN,move(molecule_a) );
-			if ( Program == "orca" ) { grid1.calculate_density_orca(); }
-			else { grid1.calculate_density(); }	 
-			gridgen grid2 ( grdN,move(molecule_b) );
-			if ( Program == "orca" ) { grid2.calculate_density_orca(); }
-			else { grid2.calculate_density(); }
-			gridgen grid3 ( grdN, move(molecule_c) );
-			if ( Program == "orca" ) { grid3.calculate_density_orca(); }
-			else { grid3.calculate_density(); }
-			grid2.molecule.clear();
-			grid3.molecule.clear();
-			local_rd lrdVol_1(grid1.density,grid2.density,grid3.density,charge);
+			Icube dens_neutro;
+			Icube dens_cation;
+			Icube dens_anion;
+			if ( needed[2] || fukui ){
+				if ( Program == "orca" ) { grid1.calculate_density_orca(); }
+				else { grid1.calculate_density(); }
+				dens_neutro = move(grid1.density);
+			}
+			if ( needed[3] || fukui ){
+				gridgen grid2 ( grdN,move(molecule_b) );
+				if ( Program == "orca" ) { grid2.calculate_density_orca(); }
+				else { grid2.calculate_density(); }
+				dens_cation = move(grid2.density);
+			}
+			if ( needed[4] || fukui ){
+				gridgen grid3 ( grdN, move(molecule_c) );
+				if ( Program == "orca" ) { grid3.calculate_density_orca(); }
+				else { grid3.calculate_density(); }
+				dens_anion = move(grid3.density);
+			}
+			local_rd lrdVol_1(dens_neutro,dens_cation,dens_anion,charge);
+			lrdVol_1.name = grid1.name;
 			if ( loc_hard == "TFD" ){ lrdVol.TFD = true;};
-			lrdVol_1.calculate_Fukui_potential();
 			lrdVol_1.calculate_RD(grd);
-			lrdVol_1.calculate_hardness(grd);
-			lrdVol_1.calculate_MEP(grid1.molecule);
+			lrdVol_1.calculate_Fukui_potential();
+			if ( needed[2] ){
+				lrdVol_1.calculate_hardness(grd);
+				lrdVol_1.calculate_MEP(grid1.molecule);
+			}
 			lrdVol_1.write_LRD();
 			lrdVol = move(lrdVol_1);
 			if ( pymol_script ) {
@@ -311,7 +341,7 @@ void primordia::init_protein_RD(const char* file_name	,
 	m_log->input_message("\n\tEnergy criteria "+std::to_string(energy_crit)+" (eV)\n\n" );
 	//---------------------------------------------------------------------
 	
-	QMparser fileQM ( file_name,Program );
+	QMparser fileQM ( file_name,Program,bandgap );
 	Imolecule molecule( fileQM.get_molecule() );
 	if ( molecule.name == "empty"){
 		m_log->write_warning("Molecular information not used for calculations! Entry "+name);
@@ -354,7 +384,10 @@ void primordia::init_protein_RD(const char* file_name	,
 			ch_rd.calculate_protein(bio_rd,pdbfile);
 			ch_rd.write_comp_hardness( name.c_str() );
 		}
-		if ( gridN > 0 ){
+		std::vector<bool> needed = lrd_needed();
+		bool fukui	= needed[5] || needed[6] || needed[20];
+		bool dens	= needed[2] && ( locHardness == "true" || locHardness == "TFD" );
+		if ( gridN > 0 && ( needed[0] || needed[1] || fukui || dens ) ){
 			gridgen grid ( gridN,move(molecule) );
 			if ( size > 0 ) { 
 				grid.redefine_lim(ref_atom[0],ref_atom[1],ref_atom[2],size);
@@ -363,24 +396,26 @@ void primordia::init_protein_RD(const char* file_name	,
 			Icube LUMO;
 			Icube EAS;
 			Icube NAS;
-			HOMO = grid.calc_HOMO();
-			LUMO = grid.calc_LUMO();
-			if ( bt == "BD" ){
-				EAS  = grid.calc_band_EAS(bandgap);
-				NAS  = grid.calc_band_NAS(bandgap);
-			}else if ( bt == "EW" ){
-				EAS = grid.calc_EBLC_EAS();
-				NAS = grid.calc_EBLC_NAS();
+			if ( needed[0] ) HOMO = grid.calc_HOMO();
+			if ( needed[1] ) LUMO = grid.calc_LUMO();
+			if ( fukui ){
+				if ( bt == "BD" ){
+					EAS  = grid.calc_band_EAS(bandgap);
+					NAS  = grid.calc_band_NAS(bandgap);
+				}else if ( bt == "EW" ){
+					EAS = grid.calc_EBLC_EAS();
+					NAS = grid.calc_EBLC_NAS();
+				}
 			}
-			if (  locHardness == "true" || locHardness == "TFD" ){
+			if ( dens ){
 				grid.calculate_density();
-				lrdVol = local_rd(grid.density,HOMO,LUMO);
+				lrdVol = local_rd(move(grid.density),HOMO,LUMO);
 				lrdVol.calculate_hardness(grd);
 				lrdVol.calculate_MEP(grid.molecule);
 			}else{ 
 				lrdVol = local_rd(HOMO,LUMO);
 			}
-			lrdVol.calculate_fukui_Band(EAS,NAS);
+			if ( fukui ) lrdVol.calculate_fukui_Band(EAS,NAS);
 			lrdVol.name = name;
 			lrdVol.calculate_Fukui_potential();
 			lrdVol.calculate_RD(grd);
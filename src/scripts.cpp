@@ -198,21 +198,21 @@ void scripts::write_pymol_cube(local_rd& lrdVol){
 		
 		
 		script_file	<< "load "	<< pdb_name									<< " \n"
-					<< "load "	<< typestr << lrdVol.lrds[0].name			<< "_ph1.cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[0].name			<< "_ph2.cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[1].name			<< "_ph1.cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[1].name			<< "_ph2.cube\n"
+					<< "load "	<< typestr << lrdVol.lrds[0].name			<< ".cube, " << typestr2 << lrdVol.lrds[0].name << "_ph1\n"
+					<< "load "	<< typestr << lrdVol.lrds[0].name			<< ".cube, " << typestr2 << lrdVol.lrds[0].name << "_ph2\n"
+					<< "load "	<< typestr << lrdVol.lrds[1].name			<< ".cube, " << typestr2 << lrdVol.lrds[1].name << "_ph1\n"
+					<< "load "	<< typestr << lrdVol.lrds[1].name			<< ".cube, " << typestr2 << lrdVol.lrds[1].name << "_ph2\n"
 					<< "load "	<< typestr << lrdVol.lrds[5].name			<< ".cube\n"
 					<< "load "	<< typestr << lrdVol.lrds[6].name			<< ".cube\n"
 					<< "load "	<< typestr << lrdVol.lrds[7].name			<< ".cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[8].name			<< "_ph1.cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[8].name			<< "_ph2.cube\n"
+					<< "load "	<< typestr << lrdVol.lrds[8].name			<< ".cube, " << typestr2 << lrdVol.lrds[8].name << "_ph1\n"
+					<< "load "	<< typestr << lrdVol.lrds[8].name			<< ".cube, " << typestr2 << lrdVol.lrds[8].name << "_ph2\n"
 					<< "load "	<< typestr << lrdVol.lrds[9].name			<< ".cube\n"
 					<< "load "	<< typestr << lrdVol.lrds[10].name			<< ".cube\n"
 					<< "load "	<< typestr << lrdVol.lrds[11].name			<< ".cube\n"
 					<< "load "	<< typestr << lrdVol.lrds[14].name			<< ".cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[15].name			<< "_ph1.cube\n"
-					<< "load "	<< typestr << lrdVol.lrds[15].name			<< "_ph2.cube\n"
+					<< "load "	<< typestr << lrdVol.lrds[15].name			<< ".cube, " << typestr2 << lrdVol.lrds[15].name << "_ph1\n"
+					<< "load "	<< typestr << lrdVol.lrds[15].name			<< ".cube, " << typestr2 << lrdVol.lrds[15].name << "_ph2\n"
 					<< "volume " << typestr2 << lrdVol.lrds[0].name			<< "_ph1_volume, "	<< typestr2 << lrdVol.lrds[0].name	<<	"_ph1"	<< " \n" 
 					<< "volume " << typestr2 << lrdVol.lrds[0].name			<< "_ph2_volume, "	<< typestr2 << lrdVol.lrds[0].name	<<	"_ph2"	<< " \n" 
 					<< "volume " << typestr2 << lrdVol.lrds[1].name			<< "_ph1_volume, "	<< typestr2 << lrdVol.lrds[1].name	<<	"_ph1"	<< " \n" 
@@ -249,10 +249,10 @@ void scripts::write_pymol_cube(local_rd& lrdVol){
 						<< "load "	<< typestr << lrdVol.lrds[13].name			<< ".cube\n"
 						<< "load "	<< typestr << lrdVol.lrds[16].name			<< ".cube\n"
 						<< "load "	<< typestr << lrdVol.lrds[17].name			<< ".cube\n"
-						<< "load "	<< typestr << lrdVol.lrds[18].name			<< "_ph1.cube\n"
-						<< "load "	<< typestr << lrdVol.lrds[18].name			<< "_ph2.cube\n"
-						<< "load "	<< typestr << lrdVol.lrds[19].name			<< "_ph1.cube\n"
-						<< "load "	<< typestr << lrdVol.lrds[19].name			<< "_ph2.cube\n"
+						<< "load "	<< typestr << lrdVol.lrds[18].name			<< ".cube, " << typestr2 << lrdVol.lrds[18].name << "_ph1\n"
+						<< "load "	<< typestr << lrdVol.lrds[18].name			<< ".cube, " << typestr2 << lrdVol.lrds[18].name << "_ph2\n"
+						<< "load "	<< typestr << lrdVol.lrds[19].name			<< ".cube, " << typestr2 << lrdVol.lrds[19].name << "_ph1\n"
+						<< "load "	<< typestr << lrdVol.lrds[19].name			<< ".cube, " << typestr2 << lrdVol.lrds[19].name << "_ph2\n"
 						<< "load "	<< typestr << lrdVol.lrds[20].name			<< ".cube\n"
 						<< "load "	<< typestr << lrdVol.lrds[21].name			<< ".cube\n"
 						<< "volume " << typestr2 << lrdVol.lrds[12].name		<< "_volume, "		<< typestr2	<< lrdVol.lrds[12].name	<< " \n" 
@@ -0,0 +1,380 @@
+//volume_file.cpp
+
+/*********************************************************************/
+/* This source code file is part of PRIMoRDiA software project created
+ * by Igor Barden Grillo at Federal University of Paraíba.
+ * barden.igor@gmail.com ( Personal e-mail )
+ * igor.grillo@acad.pucrs.br ( Academic e-mail )
+ * quantum-chem.pro.br ( group site )
+ * IgorChem ( Git Hub account )
+ */
+
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+//------------------------------------------
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <omp.h>
+//------------------------------------------
+#include "../include/common.h"
+#include "../include/log_class.h"
+#include "../include/Iatom.h"
+#include "../include/Imolecule.h"
+#include "../include/Icube.h"
+#include "../include/Imapped_file.h"
+#include "../include/volume_file.h"
+//------------------------------------------
+using std::string;
+using std::vector;
+using std::move;
+using std::cout;
+using std::endl;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+
+static const uint32_t volume_version = 1;
+
+/*==============================================*/
+// lossless codec of the field values: each value is replaced by the exclusive or with the
+// previous one, which leaves null high bytes in smooth regions, the bytes are grouped by
+// significance and the runs of null bytes are stored as a zero followed by the run length,
+// the other bytes go in literal runs of up to 255 bytes preceded by their count.
+template<class W>
+static vector<uint8_t> encode_field(const char* src, std::size_t n){
+	const unsigned int ws = sizeof(W);
+	vector<uint8_t> planes(n*ws);
+	omp_set_num_threads(NP);
+	#pragma omp parallel for
+	for( long long i=0; i<(long long)n; i++ ){
+		W w, prev = 0;
+		std::memcpy(&w,src+i*ws,ws);
+		if ( i > 0 ) std::memcpy(&prev,src+(i-1)*ws,ws);
+		W d = w^prev;
+		for( unsigned int b=0; b<ws; b++ ) planes[b*n+i] = uint8_t( d >> (8*b) );
+	}
+	vector<uint8_t> out;
+	out.reserve(planes.size()/4);
+	std::size_t p = 0, N = planes.size();
+	while( p < N ){
+		std::size_t z = p;
+		while( z < N && planes[z] == 0 ) z++;
+		if ( z - p >= 2 ){
+			out.push_back(0);
+			uint64_t len = z - p;
+			while( len >= 0x80 ){ out.push_back( uint8_t(len | 0x80) ); len >>= 7; }
+			out.push_back( uint8_t(len) );
+			p = z;
+			continue;
+		}
+		std::size_t q = p;
+		while( q < N && q - p < 255 ){
+			if ( planes[q] == 0 && q+1 < N && planes[q+1] == 0 ) break;
+			q++;
+		}
+		out.push_back( uint8_t(q-p) );
+		out.insert(out.end(),planes.begin()+p,planes.begin()+q);
+		p = q;
+	}
+	return out;
+}
+/******************************************************************/
+template<class W>
+static bool decode_field(const uint8_t* in, std::size_t nbytes, std::size_t n, char* dst){
+	const unsigned int ws = sizeof(W);
+	vector<uint8_t> planes(n*ws);
+	std::size_t pos = 0, o = 0, N = planes.size();
+	while( pos < nbytes && o < N ){
+		uint8_t c = in[pos++];
+		if ( c == 0 ){
+			uint64_t len = 0;
+			unsigned int shift = 0;
+			while( pos < nbytes ){
+				uint8_t b = in[pos++];
+				len |= uint64_t(b & 0x7f) << shift;
+				shift += 7;
+				if ( !(b & 0x80) ) break;
+			}
+			if ( len > N - o ) return false;
+			o += len; // planes are zero initialized
+		}else{
+			if ( c > nbytes - pos || c > N - o ) return false;
+			std::memcpy(&planes[o],in+pos,c);
+			pos += c;
+			o	+= c;
+		}
+	}
+	if ( o != N ) return false;
+	W prev = 0;
+	for( std::size_t i=0; i<n; i++ ){
+		W d = 0;
+		for( unsigned int b=0; b<ws; b++ ) d |= W(planes[b*n+i]) << (8*b);
+		prev ^= d;
+		std::memcpy(dst+i*ws,&prev,ws);
+	}
+	return true;
+}
+/******************************************************************/
+template<class T>
+static void put(std::ofstream& file, const T& val){
+	file.write(reinterpret_cast<const char*>(&val),sizeof(T));
+}
+/******************************************************************/
+static void put_string(std::ofstream& file, const string& str){
+	put( file, uint32_t( str.size() ) );
+	file.write(str.data(),str.size());
+}
+/*==============================================*/
+volume_writer::volume_writer(const string& file_name	,
+							const Icube& grid_ref		,
+							bool single_prec			,
+							bool compression			):
+	name(file_name)										,
+	single(single_prec)									,
+	compress(compression)								,
+	file(file_name.c_str(),std::ios::binary)			{
+
+	if ( !file.is_open() ){
+		cout << "Error in openning the volume file: " << file_name << endl;
+		m_log->write_error("Error in openning the volume file: " + file_name);
+		return;
+	}
+	file.write("PVOL",4);
+	put(file,volume_version);
+	for( int i=0; i<3; i++ ) put( file, uint32_t(grid_ref.grid[i]) );
+	for( int i=0; i<3; i++ ) put( file, grid_ref.origin[i] );
+	for( int i=0; i<3; i++ ) put( file, grid_ref.gridsides[i] );
+	uint32_t nat = grid_ref.molecule ? grid_ref.molecule->num_of_atoms : 0;
+	put(file,nat);
+	for( unsigned int i=0; i<nat; i++ ){
+		const Iatom& atom = grid_ref.molecule->atoms[i];
+		put( file, uint32_t(atom.atomicN) );
+		put( file, atom.xcoord );
+		put( file, atom.ycoord );
+		put( file, atom.zcoord );
+	}
+}
+/******************************************************************/
+void volume_writer::add_field(const Icube& cube, const string& field_name){
+	if ( !file.is_open() ) return;
+	volume_field field;
+	field.name			= field_name;
+	field.header		= cube.header;
+	field.elec_dens		= cube.elec_dens;
+	field.MOn			= cube.MOn;
+	field.value_size	= single ? 4 : 8;
+	field.codec			= 0;
+	field.offset		= file.tellp();
+
+	std::size_t n = cube.scalar.size();
+	vector<float> values_f;
+	const char* src = reinterpret_cast<const char*>( cube.scalar.data() );
+	if ( single ){
+		values_f.assign( cube.scalar.begin(), cube.scalar.end() );
+		src = reinterpret_cast<const char*>( values_f.data() );
+	}
+	field.nbytes = n*field.value_size;
+	vector<uint8_t> packed;
+	if ( compress ){
+		if ( single )	packed = encode_field<uint32_t>(src,n);
+		else			packed = encode_field<uint64_t>(src,n);
+		if ( packed.size() < field.nbytes ){
+			field.codec		= 1;
+			field.nbytes	= packed.size();
+			src = reinterpret_cast<const char*>( packed.data() );
+		}
+	}
+	file.write(src,field.nbytes);
+	fields.push_back( move(field) );
+}
+/******************************************************************/
+void volume_writer::close(){
+	if ( !file.is_open() ) return;
+	uint64_t index_offset = file.tellp();
+	put( file, uint32_t( fields.size() ) );
+	for( unsigned int i=0; i<fields.size(); i++ ){
+		put_string( file, fields[i].name );
+		put_string( file, fields[i].header );
+		put( file, uint8_t(fields[i].elec_dens) );
+		put( file, int32_t(fields[i].MOn) );
+		put( file, uint8_t(fields[i].value_size) );
+		put( file, uint8_t(fields[i].codec) );
+		put( file, fields[i].offset );
+		put( file, fields[i].nbytes );
+	}
+	put(file,index_offset);
+	file.write("PVIX",4);
+	file.close();
+}
+/******************************************************************/
+volume_writer::~volume_writer(){ this->close(); }
+/*==============================================*/
+// bounds checked sequential reading of the mapped file
+class volume_cursor {
+	public:
+		const char* it;
+		const char* fin;
+		bool ok;
+		volume_cursor(const char* in, const char* end) : it(in), fin(end), ok(in <= end) {}
+		template<class T> T get(){
+			T val = T();
+			if ( ok && std::size_t(fin - it) >= sizeof(T) ){
+				std::memcpy(&val,it,sizeof(T));
+				it += sizeof(T);
+			}else ok = false;
+			return val;
+		}
+		string get_string(){
+			uint32_t len = get<uint32_t>();
+			if ( !ok || std::size_t(fin - it) < len ){ ok = false; return string(); }
+			string str(it,len);
+			it += len;
+			return str;
+		}
+};
+/******************************************************************/
+volume_reader::volume_reader(const char* file_name)	:
+	name(file_name)									,
+	valid(false)									,
+	map( new Imapped_file(file_name) )				{
+
+	for( int i=0; i<3; i++ ){
+		grid[i]		= 0;
+		origin[i]	= 0.0;
+		gridsides[i]= 0.0;
+	}
+	if ( !map->is_open() ){
+		cout << "Error in openning the volume file: " << file_name << endl;
+		m_log->write_error("Error in openning the volume file: " + name);
+		return;
+	}
+	const char* beg = map->begin();
+	const char* end = map->end();
+	if ( map->size < 16 || std::memcmp(beg,"PVOL",4) != 0 || std::memcmp(end-4,"PVIX",4) != 0 ){
+		cout << "The file is not a PRIMoRDiA volume file: " << file_name << endl;
+		m_log->write_error("The file is not a PRIMoRDiA volume file: " + name);
+		return;
+	}
+	volume_cursor head(beg+4,end);
+	uint32_t version = head.get<uint32_t>();
+	for( int i=0; i<3; i++ ) grid[i]		= head.get<uint32_t>();
+	for( int i=0; i<3; i++ ) origin[i]		= head.get<double>();
+	for( int i=0; i<3; i++ ) gridsides[i]	= head.get<double>();
+	uint32_t nat = head.get<uint32_t>();
+	Imolecule mol;
+	for( uint32_t i=0; i<nat && head.ok; i++ ){
+		Iatom atom;
+		atom.atomicN	= head.get<uint32_t>();
+		atom.xcoord		= head.get<double>();
+		atom.ycoord		= head.get<double>();
+		atom.zcoord		= head.get<double>();
+		mol.add_atom( atom );
+	}
+	molecule = std::make_shared<const Imolecule>( move(mol) );
+
+	uint64_t index_offset;
+	std::memcpy(&index_offset,end-12,sizeof(uint64_t));
+	volume_cursor index( beg + std::min<uint64_t>(index_offset,map->size), end-12 );
+	uint32_t nfields = index.get<uint32_t>();
+	for( uint32_t i=0; i<nfields && index.ok; i++ ){
+		volume_field field;
+		field.name			= index.get_string();
+		field.header		= index.get_string();
+		field.elec_dens		= index.get<uint8_t>() != 0;
+		field.MOn			= index.get<int32_t>();
+		field.value_size	= index.get<uint8_t>();
+		field.codec			= index.get<uint8_t>();
+		field.offset		= index.get<uint64_t>();
+		field.nbytes		= index.get<uint64_t>();
+		if ( field.offset > map->size || field.nbytes > map->size - field.offset ) index.ok = false;
+		if ( index.ok ) fields.push_back( move(field) );
+	}
+	valid = head.ok && index.ok && version == volume_version;
+	if ( !valid ){
+		cout << "Corrupted or incompatible volume file: " << file_name << endl;
+		m_log->write_error("Corrupted or incompatible volume file: " + name);
+	}
+}
+/******************************************************************/
+int volume_reader::find_field(const string& field_name) const {
+	for( unsigned int i=0; i<fields.size(); i++ ){
+		if ( fields[i].name == field_name ) return i;
+	}
+	return -1;
+}
+/******************************************************************/
+Icube volume_reader::get_field(unsigned int i) const {
+	Icube cube;
+	if ( !valid || i >= fields.size() ) return cube;
+	const volume_field& field = fields[i];
+	cube.name		= field.name;
+	cube.header		= field.header;
+	cube.elec_dens	= field.elec_dens;
+	cube.MOn		= field.MOn;
+	cube.molecule	= molecule;
+	for( int j=0; j<3; j++ ){
+		cube.grid[j]		= grid[j];
+		cube.origin[j]		= origin[j];
+		cube.gridsides[j]	= gridsides[j];
+	}
+	cube.voxelN = grid[0]*grid[1]*grid[2];
+	cube.scalar.resize(cube.voxelN);
+	std::size_t n		= cube.voxelN;
+	const char* data	= map->begin() + field.offset;
+	bool ok				= true;
+	vector<float> values_f;
+	char* dst = reinterpret_cast<char*>( cube.scalar.data() );
+	if ( field.value_size == 4 ){
+		values_f.resize(n);
+		dst = reinterpret_cast<char*>( values_f.data() );
+	}
+	if ( field.codec == 1 ){
+		const uint8_t* in = reinterpret_cast<const uint8_t*>(data);
+		if ( field.value_size == 4 )	ok = decode_field<uint32_t>(in,field.nbytes,n,dst);
+		else							ok = decode_field<uint64_t>(in,field.nbytes,n,dst);
+	}else{
+		ok = field.nbytes == n*field.value_size;
+		if ( ok ) std::memcpy(dst,data,field.nbytes);
+	}
+	if ( ok && field.value_size == 4 ){
+		for( std::size_t j=0; j<n; j++ ) cube.scalar[j] = values_f[j];
+	}
+	if ( !ok ){
+		cout << "Corrupted field " << field.name << " in the volume file: " << name << endl;
+		m_log->write_error("Corrupted field " + field.name + " in the volume file: " + name);
+		std::fill(cube.scalar.begin(),cube.scalar.end(),0.0);
+	}
+	return cube;
+}
+/******************************************************************/
+Icube volume_reader::get_field(const string& field_name) const {
+	int i = this->find_field(field_name);
+	if ( i < 0 ){
+		cout << "Field " << field_name << " not found in the volume file: " << name << endl;
+		m_log->write_warning("Field " + field_name + " not found in the volume file: " + name);
+		return Icube();
+	}
+	return this->get_field(i);
+}
+/******************************************************************/
+volume_reader::~volume_reader(){}
+/*==============================================*/
+Icube load_cube(const string& file_spec){
+	std::size_t ext = file_spec.find(".pvol");
+	if ( ext == string::npos ) return Icube( file_spec.c_str() );
+	string file_name = file_spec.substr(0,ext+5);
+	volume_reader volume( file_name.c_str() );
+	if ( ext+5 < file_spec.size() && file_spec[ext+5] == ':' ){
+		return volume.get_field( file_spec.substr(ext+6) );
+	}
+	return volume.get_field(0);
+}
+//================================================================================
+//END OF FILE
+//================================================================================